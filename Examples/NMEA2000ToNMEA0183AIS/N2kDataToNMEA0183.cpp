@@ -27,27 +27,32 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <NMEA0183Messages.h>
 #include <NMEA0183AISMessages.h>
 #include <NMEA0183AISMsg.h>
+#include <NMEA0183AISDecoder.h>
 
 #define SERIAL_PRINT_AIS_NMEA    // Prints the !AIVDM NMEA sentence on Serial
 //#define SERIAL_PRINT_AIS_FIELDS  // Prints parsed datas derived from N2kParser
 
+//*****************************************************************************
+// Handled PGNs, keep sorted by PGN
+const tN2kDataToNMEA0183::tPGNDispatcher::tEntry tN2kDataToNMEA0183::PGNHandlers[]={
+  { 127250UL, &tN2kDataToNMEA0183::HandleHeading },
+  { 127258UL, &tN2kDataToNMEA0183::HandleVariation },
+  { 128259UL, &tN2kDataToNMEA0183::HandleBoatSpeed },
+  { 128267UL, &tN2kDataToNMEA0183::HandleDepth },
+  { 129025UL, &tN2kDataToNMEA0183::HandlePosition },
+  { 129026UL, &tN2kDataToNMEA0183::HandleCOGSOG },
+  { 129029UL, &tN2kDataToNMEA0183::HandleGNSS },
+  { 129038UL, &tN2kDataToNMEA0183::HandleAISClassAPosReport },      // AIS Class A Position Report, Message Type 1
+  { 129039UL, &tN2kDataToNMEA0183::HandleAISClassBMessage18 },      // AIS Class B Position Report, Message Type 18
+  { 129794UL, &tN2kDataToNMEA0183::HandleAISClassAMessage5 },       // AIS Class A Ship Static and Voyage related data, Message Type 5
+  { 129809UL, &tN2kDataToNMEA0183::HandleAISClassBMessage24A },     // AIS Class B "CS" Static Data Report, Part A
+  { 129810UL, &tN2kDataToNMEA0183::HandleAISClassBMessage24B },     // AIS Class B "CS" Static Data Report, Part B
+};
+const size_t tN2kDataToNMEA0183::PGNHandlerCount=sizeof(PGNHandlers)/sizeof(PGNHandlers[0]);
+
 //*****************************************************************************
 void tN2kDataToNMEA0183::HandleMsg(const tN2kMsg &N2kMsg) {
-  switch (N2kMsg.PGN) {
-    case 127250UL: HandleHeading(N2kMsg); break;
-    case 127258UL: HandleVariation(N2kMsg); break;
-    case 128259UL: HandleBoatSpeed(N2kMsg); break;
-    case 128267UL: HandleDepth(N2kMsg); break;
-    case 129025UL: HandlePosition(N2kMsg); break;
-    case 129026UL: HandleCOGSOG(N2kMsg); break;
-    case 129029UL: HandleGNSS(N2kMsg); break;
-    // AIS
-    case 129038UL: HandleAISClassAPosReport(N2kMsg); break;   // AIS Class A Position Report, Message Type 1
-    case 129039UL: HandleAISClassBMessage18(N2kMsg); break;   // AIS Class B Position Report, Message Type 18
-    case 129794UL: HandleAISClassAMessage5(N2kMsg);  break;   // AIS Class A Ship Static and Voyage related data, Message Type 5
-    case 129809UL: HandleAISClassBMessage24A(N2kMsg); break;  // AIS Class B "CS" Static Data Report, Part A
-    case 129810UL: HandleAISClassBMessage24B(N2kMsg); break;  // AIS Class B "CS" Static Data Report, Part B
-  }
+  PGNDispatcher.Dispatch(*this, N2kMsg);
 }
 
 //*****************************************************************************
@@ -59,9 +64,18 @@ void tN2kDataToNMEA0183::Update() {
 }
 
 //*****************************************************************************
-void tN2kDataToNMEA0183::SendMessage(const tNMEA0183Msg &NMEA0183Msg) {
-  if ( pNMEA0183!=0 ) pNMEA0183->SendMessage(NMEA0183Msg);
-  if ( SendNMEA0183MessageCallback!=0 ) SendNMEA0183MessageCallback(NMEA0183Msg);
+void tN2kDataToNMEA0183::SendMessage(const tNMEA0183Msg &NMEA0183Msg, uint32_t Sinks) {
+  if ( pNMEA0183!=0 && ( Sinks & ((uint32_t)1<<NMEA0183Sink) )!=0 ) pNMEA0183->SendMessage(NMEA0183Msg);
+  if ( SendNMEA0183MessageCallback!=0 && ( Sinks & ((uint32_t)1<<CallbackSink) )!=0 ) SendNMEA0183MessageCallback(NMEA0183Msg);
+}
+
+//*****************************************************************************
+// Position report only to the outputs, whose period for the target has elapsed
+// or which have not got a significant change of it yet.
+void tN2kDataToNMEA0183::SendPositionReport(const tNMEA0183AISMsg &NMEA0183AISMsg) {
+  uint32_t Sinks=AISDecimator.Pass(millis(), tAISReportDecimator::AllSinks,
+                                   NMEA0183AISMsg.GetPayloadBits(), NMEA0183AISMsg.GetPayloadBitCount());
+  if ( Sinks!=0 ) SendMessage(NMEA0183AISMsg, Sinks);
 }
 
 //*****************************************************************************
@@ -188,73 +202,52 @@ void tN2kDataToNMEA0183::SendRMC() {
 //*****************************************************************************
 // 129038 AIS Class A Position Report (Message 1, 2, 3)
 void tN2kDataToNMEA0183::HandleAISClassAPosReport(const tN2kMsg &N2kMsg) {
-  uint8_t _MessageID;
-  tN2kAISRepeat _Repeat;
-  uint32_t _UserID;  // MMSI
-  double _Latitude;
-  double _Longitude;
-  bool _Accuracy;
-  bool _RAIM;
-  uint8_t _Seconds;
-  double _COG;
-  double _SOG;
-  double _Heading;
-  tN2kAISUnit _Unit;
-  bool _Display, _DSC, _Band, _Msg22, _State;
-  tN2kAISMode _Mode;
-  tN2kAISTransceiverInformation _AISTransceiverInformation;
-
   tNMEA0183AISMsg NMEA0183AISMsg;
-  double _ROT;
-  tN2kAISNavStatus _NavStatus;
-
-  uint8_t _MessageType = 1;
-
-  if ( ParseN2kPGN129039(N2kMsg, _MessageID, _Repeat, _UserID, _Latitude, _Longitude, _Accuracy, _RAIM,
-                     _Seconds, _COG, _SOG, _AISTransceiverInformation, _Heading, _Unit, _Display, _DSC, _Band, _Msg22, _Mode, _State) ) {
 
+  // PGN fields are converted to AIS units directly, without ParseN2kPGN129038 and double values
+  if ( SetAISClassABMessage1(AISContext, NMEA0183AISMsg, N2kMsg) ) {
 
     // Debug
     #ifdef SERIAL_PRINT_AIS_FIELDS
-      Serial.println("–––––––––––––––––––––––– Msg 1 ––––––––––––––––––––––––––––––––");
-
-      const double pi=3.1415926535897932384626433832795;
-      const double radToDeg=180.0/pi;
-      const double msTokn=3600.0/1852.0;
-      const double radsToDegMin = 60 * 360.0 / (2 * pi);    // [rad/s -> degree/minute]
-      Serial.print("Repeat: "); Serial.println(_Repeat);
-      Serial.print("UserID: "); Serial.println(_UserID);
-      Serial.print("Latitude: "); Serial.println(_Latitude);
-      Serial.print("Longitude: "); Serial.println(_Longitude);
-      Serial.print("Accuracy: "); Serial.println(_Accuracy);
-      Serial.print("RAIM: "); Serial.println(_RAIM);
-      Serial.print("Seconds: "); Serial.println(_Seconds);
-      Serial.print("COG: "); Serial.println(_COG*radToDeg);
-      Serial.print("SOG: "); Serial.println(_SOG*msTokn);
-      Serial.print("Heading: "); Serial.println(_Heading*radToDeg);
-      Serial.print("ROT: "); Serial.println(_ROT*radsToDegMin);
-      Serial.print("NavStatus: "); Serial.println(_NavStatus);
+      tAISClassAPositionReport Report;
+      if ( AISDecodeClassAPositionReport(NMEA0183AISMsg.GetPayloadBits(), NMEA0183AISMsg.GetPayloadBitCount(), Report) ) {
+        Serial.println("–––––––––––––––––––––––– Msg 1 ––––––––––––––––––––––––––––––––");
+
+        const double pi=3.1415926535897932384626433832795;
+        const double radToDeg=180.0/pi;
+        const double msTokn=3600.0/1852.0;
+        const double radsToDegMin = 60 * 360.0 / (2 * pi);    // [rad/s -> degree/minute]
+        Serial.print("Repeat: "); Serial.println(Report.Repeat);
+        Serial.print("UserID: "); Serial.println(Report.UserID);
+        Serial.print("Latitude: "); Serial.println(Report.Latitude);
+        Serial.print("Longitude: "); Serial.println(Report.Longitude);
+        Serial.print("Accuracy: "); Serial.println(Report.Accuracy);
+        Serial.print("RAIM: "); Serial.println(Report.RAIM);
+        Serial.print("Seconds: "); Serial.println(Report.Seconds);
+        Serial.print("COG: "); Serial.println(Report.COG*radToDeg);
+        Serial.print("SOG: "); Serial.println(Report.SOG*msTokn);
+        Serial.print("Heading: "); Serial.println(Report.Heading*radToDeg);
+        Serial.print("ROT: "); Serial.println(Report.ROT*radsToDegMin);
+        Serial.print("NavStatus: "); Serial.println(Report.NavStatus);
+      }
     #endif
 
-    if ( SetAISClassABMessage1(NMEA0183AISMsg, _MessageType, _Repeat, _UserID, _Latitude, _Longitude, _Accuracy,
-                          _RAIM, _Seconds, _COG, _SOG, _Heading, _ROT, _NavStatus ) ) {
-
-      SendMessage(NMEA0183AISMsg);
+    AISTargets.UpdatePosition(millis(), NMEA0183AISMsg.GetPayloadBits(), NMEA0183AISMsg.GetPayloadBitCount());
+    SendPositionReport(NMEA0183AISMsg);
 
-      #ifdef SERIAL_PRINT_AIS_NMEA
-        // Debug Print AIS-NMEA
-        Serial.print(NMEA0183AISMsg.GetPrefix());
-        Serial.print(NMEA0183AISMsg.Sender());
-        Serial.print(NMEA0183AISMsg.MessageCode());
-        for (int i=0; i<NMEA0183AISMsg.FieldCount(); i++) {
-          Serial.print(",");
-          Serial.print(NMEA0183AISMsg.Field(i));
-        }
-        char buf[7];
-        sprintf(buf,"*%02X\r\n",NMEA0183AISMsg.GetCheckSum());
-        Serial.print(buf);
-      #endif
-    }
+    #ifdef SERIAL_PRINT_AIS_NMEA
+      // Debug Print AIS-NMEA
+      Serial.print(NMEA0183AISMsg.GetPrefix());
+      Serial.print(NMEA0183AISMsg.Sender());
+      Serial.print(NMEA0183AISMsg.MessageCode());
+      for (int i=0; i<NMEA0183AISMsg.FieldCount(); i++) {
+        Serial.print(",");
+        Serial.print(NMEA0183AISMsg.Field(i));
+      }
+      char buf[7];
+      sprintf(buf,"*%02X\r\n",NMEA0183AISMsg.GetCheckSum());
+      Serial.print(buf);
+    #endif
   }
 }  // end 129038 AIS Class A Position Report Message 1/3
 
@@ -313,7 +306,11 @@ void tN2kDataToNMEA0183::HandleAISClassAMessage5(const tN2kMsg &N2kMsg) {
       Serial.println("––––––––––––––––––––––– Msg 5 –––––––––––––––––––––––––––––––––");
     #endif
 
-    if ( SetAISClassAMessage5(NMEA0183AISMsg, _MessageID, _Repeat, _UserID, _IMONumber, _Callsign, _Name, _VesselType,
+    AISTargets.UpdateClassAStatic(millis(), _Repeat, _UserID, _IMONumber, _Callsign, _Name, _VesselType,
+                              _Length, _Beam, _PosRefStbd, _PosRefBow, _ETAdate, _ETAtime, _Draught, _Destination,
+                              _GNSStype, _DTE);
+
+    if ( SetAISClassAMessage5(AISContext, NMEA0183AISMsg, _MessageID, _Repeat, _UserID, _IMONumber, _Callsign, _Name, _VesselType,
                               _Length, _Beam, _PosRefStbd, _PosRefBow, _ETAdate, _ETAtime, _Draught, _Destination,
                               _GNSStype, _DTE ) ) {
 
@@ -355,46 +352,27 @@ void tN2kDataToNMEA0183::HandleAISClassAMessage5(const tN2kMsg &N2kMsg) {
 //*****************************************************************************
 // 129039 AIS Class B Position Report (Message 18)
 void tN2kDataToNMEA0183::HandleAISClassBMessage18(const tN2kMsg &N2kMsg) {
-  uint8_t _MessageID;
-  tN2kAISRepeat _Repeat;
-  uint32_t _UserID;  // MMSI
-  double _Latitude;
-  double _Longitude;
-  bool _Accuracy;
-  bool _RAIM;
-  uint8_t _Seconds;
-  double _COG;
-  double _SOG;
-  double _Heading;
-  tN2kAISUnit _Unit;
-  bool _Display, _DSC, _Band, _Msg22, _State;
-  tN2kAISMode _Mode;
-  tN2kAISTransceiverInformation _AISTransceiverInformation;
-
-  if ( ParseN2kPGN129039(N2kMsg, _MessageID, _Repeat, _UserID, _Latitude, _Longitude, _Accuracy, _RAIM,
-                     _Seconds, _COG, _SOG, _AISTransceiverInformation, _Heading, _Unit, _Display, _DSC, _Band, _Msg22, _Mode, _State) ) {
-
-    tNMEA0183AISMsg NMEA0183AISMsg;
+  tNMEA0183AISMsg NMEA0183AISMsg;
 
-    if ( SetAISClassBMessage18(NMEA0183AISMsg, _MessageID, _Repeat, _UserID, _Latitude, _Longitude, _Accuracy, _RAIM,
-                     _Seconds, _COG, _SOG, _Heading, _Unit, _Display, _DSC, _Band, _Msg22, _Mode, _State) ) {
+  // PGN fields are converted to AIS units directly, without ParseN2kPGN129039 and double values
+  if ( SetAISClassBMessage18(AISContext, NMEA0183AISMsg, N2kMsg) ) {
 
-      SendMessage(NMEA0183AISMsg);
+    AISTargets.UpdatePosition(millis(), NMEA0183AISMsg.GetPayloadBits(), NMEA0183AISMsg.GetPayloadBitCount());
+    SendPositionReport(NMEA0183AISMsg);
 
-      #ifdef SERIAL_PRINT_AIS_NMEA
-      // Debug Print AIS-NMEA
-      Serial.print(NMEA0183AISMsg.GetPrefix());
-      Serial.print(NMEA0183AISMsg.Sender());
-      Serial.print(NMEA0183AISMsg.MessageCode());
-      for (int i=0; i<NMEA0183AISMsg.FieldCount(); i++) {
-        Serial.print(",");
-        Serial.print(NMEA0183AISMsg.Field(i));
-      }
-      char buf[7];
-      sprintf(buf,"*%02X\r\n",NMEA0183AISMsg.GetCheckSum());
-      Serial.print(buf);
-      #endif
+    #ifdef SERIAL_PRINT_AIS_NMEA
+    // Debug Print AIS-NMEA
+    Serial.print(NMEA0183AISMsg.GetPrefix());
+    Serial.print(NMEA0183AISMsg.Sender());
+    Serial.print(NMEA0183AISMsg.MessageCode());
+    for (int i=0; i<NMEA0183AISMsg.FieldCount(); i++) {
+      Serial.print(",");
+      Serial.print(NMEA0183AISMsg.Field(i));
     }
+    char buf[7];
+    sprintf(buf,"*%02X\r\n",NMEA0183AISMsg.GetCheckSum());
+    Serial.print(buf);
+    #endif
   }
   return;
 }
@@ -412,13 +390,33 @@ void tN2kDataToNMEA0183::HandleAISClassBMessage24A(const tN2kMsg &N2kMsg) {
   if ( ParseN2kPGN129809 (N2kMsg, _MessageID, _Repeat, _UserID, _Name, _NameBufSize) ) {
 
     tNMEA0183AISMsg NMEA0183AISMsg;
-    if ( SetAISClassBMessage24PartA(NMEA0183AISMsg, _MessageID, _Repeat, _UserID, _Name) ) {}
+
+    AISTargets.UpdateClassBStaticPartA(millis(), _Repeat, _UserID, _Name);
+
+    if ( SetAISClassBMessage24PartA(AISContext, NMEA0183AISMsg, _MessageID, _Repeat, _UserID, _Name) ) {
+
+      SendMessage( NMEA0183AISMsg.BuildMsg24PartA(NMEA0183AISMsg) );
+
+      #ifdef SERIAL_PRINT_AIS_NMEA
+      // Debug Print AIS-NMEA
+      char buf[7];
+      Serial.print(NMEA0183AISMsg.GetPrefix());
+      Serial.print(NMEA0183AISMsg.Sender());
+      Serial.print(NMEA0183AISMsg.MessageCode());
+      for (int i=0; i<NMEA0183AISMsg.FieldCount(); i++) {
+        Serial.print(",");
+        Serial.print(NMEA0183AISMsg.Field(i));
+      }
+      sprintf(buf,"*%02X\r\n",NMEA0183AISMsg.GetCheckSum());
+      Serial.print(buf);
+      #endif
+    }
   }
   return;
 }
 
 //*****************************************************************************
-// PGN 129810 AIS Class B "CS" Static Data Report, Part B -> AIS Message 24 (2 Parts)
+// PGN 129810 AIS Class B "CS" Static Data Report, Part B -> AIS Message 24 Part B
 void tN2kDataToNMEA0183::HandleAISClassBMessage24B(const tN2kMsg &N2kMsg) {
 
   uint8_t _MessageID;
@@ -458,10 +456,13 @@ void tN2kDataToNMEA0183::HandleAISClassBMessage24B(const tN2kMsg &N2kMsg) {
 
     tNMEA0183AISMsg NMEA0183AISMsg;
 
-    if ( SetAISClassBMessage24(NMEA0183AISMsg, _MessageID, _Repeat, _UserID, _VesselType, _Vendor, _Callsign,
+    AISTargets.UpdateClassBStaticPartB(millis(), _Repeat, _UserID, _VesselType, _Vendor, _Callsign,
+                          _Length, _Beam, _PosRefStbd, _PosRefBow, _MothershipID);
+
+    if ( SetAISClassBMessage24PartB(AISContext, NMEA0183AISMsg, _MessageID, _Repeat, _UserID, _VesselType, _Vendor, _Callsign,
                           _Length, _Beam, _PosRefStbd, _PosRefBow, _MothershipID ) ) {
 
-      SendMessage( NMEA0183AISMsg.BuildMsg24PartA(NMEA0183AISMsg) );
+      SendMessage( NMEA0183AISMsg.BuildMsg24PartB(NMEA0183AISMsg) );
 
       #ifdef SERIAL_PRINT_AIS_NMEA
       // Debug Print AIS-NMEA
@@ -476,20 +477,6 @@ void tN2kDataToNMEA0183::HandleAISClassBMessage24B(const tN2kMsg &N2kMsg) {
       sprintf(buf,"*%02X\r\n",NMEA0183AISMsg.GetCheckSum());
       Serial.print(buf);
       #endif
-
-      SendMessage( NMEA0183AISMsg.BuildMsg24PartB(NMEA0183AISMsg) );
-
-      #ifdef SERIAL_PRINT_AIS_NMEA
-      Serial.print(NMEA0183AISMsg.GetPrefix());
-      Serial.print(NMEA0183AISMsg.Sender());
-      Serial.print(NMEA0183AISMsg.MessageCode());
-      for (int i=0; i<NMEA0183AISMsg.FieldCount(); i++) {
-        Serial.print(",");
-        Serial.print(NMEA0183AISMsg.Field(i));
-      }
-      sprintf(buf,"*%02X\r\n",NMEA0183AISMsg.GetCheckSum());
-      Serial.print(buf);
-      #endif
     }
   }
   return;
@@ -24,11 +24,17 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <NMEA0183.h>
 #include <NMEA2000.h>
+#include <NMEA0183AISMessages.h>
+#include <NMEA0183AISTargets.h>
+#include <NMEA0183AISDecimator.h>
+#include <NMEA0183AISPGNDispatcher.h>
 
 //------------------------------------------------------------------------------
 class tN2kDataToNMEA0183 : public tNMEA2000::tMsgHandler {
 public:
   using tSendNMEA0183MessageCallback=void (*)(const tNMEA0183Msg &NMEA0183Msg);
+  // Outputs, sinks of the AIS position report decimator
+  enum tSink { NMEA0183Sink=0, CallbackSink=1 };
 
 protected:
   static const unsigned long RMCPeriod=1000;
@@ -48,6 +54,9 @@ protected:
   unsigned long NextRMCSend;
 
   tNMEA0183 *pNMEA0183;
+  tAISEncoderContext AISContext;  // own ship names and sequential IDs for this bus
+  tAISTargetDB AISTargets;        // latest position and static data of received targets
+  tAISReportDecimator AISDecimator;  // position reports per target and output for slow links
   tSendNMEA0183MessageCallback SendNMEA0183MessageCallback;
 
 protected:
@@ -60,10 +69,11 @@ protected:
   void HandleGNSS(const tN2kMsg &N2kMsg); // 129029
   void SetNextRMCSend() { NextRMCSend=millis()+RMCPeriod; }
   void SendRMC();
-  void SendMessage(const tNMEA0183Msg &NMEA0183Msg);
+  void SendMessage(const tNMEA0183Msg &NMEA0183Msg, uint32_t Sinks=tAISReportDecimator::AllSinks);
+  void SendPositionReport(const tNMEA0183AISMsg &NMEA0183AISMsg);
 
 public:
-  tN2kDataToNMEA0183(tNMEA2000 *_pNMEA2000, tNMEA0183 *_pNMEA0183) : tNMEA2000::tMsgHandler(0,_pNMEA2000) {
+  tN2kDataToNMEA0183(tNMEA2000 *_pNMEA2000, tNMEA0183 *_pNMEA0183) : tNMEA2000::tMsgHandler(0,_pNMEA2000), PGNDispatcher(PGNHandlers, PGNHandlerCount) {
     SendNMEA0183MessageCallback=0;
     pNMEA0183=_pNMEA0183;
     Latitude=N2kDoubleNA; Longitude=N2kDoubleNA; Altitude=N2kDoubleNA;
@@ -80,6 +90,9 @@ public:
     SendNMEA0183MessageCallback=_SendNMEA0183MessageCallback;
   }
   void Update();
+  const tAISTargetDB &GetAISTargets() const { return AISTargets; }
+  // Set periods per tSink here
+  tAISReportDecimator &GetAISDecimator() { return AISDecimator; }
 
   // AIS
   void HandleAISClassAPosReport(const tN2kMsg &N2kMsg);   // 129038 AIS Class A Position Report
@@ -87,4 +100,10 @@ public:
   void HandleAISClassBMessage18(const tN2kMsg &N2kMsg);    // 129039 AIS Class B Position Report
   void HandleAISClassBMessage24A(const tN2kMsg &N2kMsg);  // 129809 AIS Class B "CS" Static Data Report, Part A
   void HandleAISClassBMessage24B(const tN2kMsg &N2kMsg);  // 129810 AIS Class B "CS" Static Data Report, Part B
+
+  // Handlers by PGN, sorted by PGN
+  typedef tAISPGNDispatcher<tN2kDataToNMEA0183> tPGNDispatcher;
+  static const tPGNDispatcher::tEntry PGNHandlers[];
+  static const size_t PGNHandlerCount;
+  tPGNDispatcher PGNDispatcher;
 };
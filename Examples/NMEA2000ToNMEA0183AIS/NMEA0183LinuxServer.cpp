@@ -0,0 +1,312 @@
+/*
+NMEA0183LinuxServer.cpp
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "NMEA0183LinuxServer.h"
+
+#if !defined(ARDUINO) && defined(__linux__)
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+//*****************************************************************************
+tNMEA0183LinuxServer::tNMEA0183LinuxServer(size_t _MaxClients, size_t _BufSize, size_t _FlushSize, unsigned long _FlushDelay)
+  : ListenSocket(-1), EpollSocket(-1), MaxClients(_MaxClients), BufSize(_BufSize), FlushSize(_FlushSize),
+    FlushDelay(_FlushDelay), DroppedLines(0), AcceptPaused(false) {
+}
+
+//*****************************************************************************
+uint64_t tNMEA0183LinuxServer::Now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec*1000+ts.tv_nsec/1000000;
+}
+
+//*****************************************************************************
+// Bound and listening socket on any address of Family or -1
+int tNMEA0183LinuxServer::OpenListenSocket(int Family, uint16_t Port) {
+  int Socket=socket(Family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if ( Socket<0 ) return -1;
+
+  int On=1, Off=0;
+  setsockopt(Socket, SOL_SOCKET, SO_REUSEADDR, &On, sizeof(On));
+
+  struct sockaddr_in6 Addr6;
+  struct sockaddr_in Addr4;
+  struct sockaddr *Addr;
+  socklen_t AddrLen;
+  if ( Family==AF_INET6 ) {
+    setsockopt(Socket, IPPROTO_IPV6, IPV6_V6ONLY, &Off, sizeof(Off));  // also IPv4 clients
+    memset(&Addr6, 0, sizeof(Addr6));
+    Addr6.sin6_family=AF_INET6;
+    Addr6.sin6_addr=in6addr_any;
+    Addr6.sin6_port=htons(Port);
+    Addr=(struct sockaddr *)&Addr6;
+    AddrLen=sizeof(Addr6);
+  } else {
+    memset(&Addr4, 0, sizeof(Addr4));
+    Addr4.sin_family=AF_INET;
+    Addr4.sin_addr.s_addr=htonl(INADDR_ANY);
+    Addr4.sin_port=htons(Port);
+    Addr=(struct sockaddr *)&Addr4;
+    AddrLen=sizeof(Addr4);
+  }
+
+  if ( bind(Socket, Addr, AddrLen)<0 || listen(Socket, SOMAXCONN)<0 ) {
+    int Error=errno;
+    close(Socket);
+    errno=Error;
+    return -1;
+  }
+  return Socket;
+}
+
+//*****************************************************************************
+bool tNMEA0183LinuxServer::Open(uint16_t Port) {
+  Close();
+
+  ListenSocket=OpenListenSocket(AF_INET6, Port);
+  if ( ListenSocket<0 && errno!=EADDRINUSE && errno!=EACCES ) ListenSocket=OpenListenSocket(AF_INET, Port);  // IPv6 disabled
+  if ( ListenSocket<0 ) return false;
+
+  EpollSocket=epoll_create1(EPOLL_CLOEXEC);
+  struct epoll_event Event;
+  Event.events=EPOLLIN;
+  Event.data.ptr=0;  // listen socket
+  if ( EpollSocket<0 || epoll_ctl(EpollSocket, EPOLL_CTL_ADD, ListenSocket, &Event)<0 ) {
+    int Error=errno;
+    Close();
+    errno=Error;
+    return false;
+  }
+  AcceptPaused=false;
+
+  return true;
+}
+
+//*****************************************************************************
+void tNMEA0183LinuxServer::Close() {
+  while ( !Clients.empty() ) Remove(Clients.back());
+  if ( EpollSocket>=0 ) { close(EpollSocket); EpollSocket=-1; }
+  if ( ListenSocket>=0 ) { close(ListenSocket); ListenSocket=-1; }
+}
+
+//*****************************************************************************
+void tNMEA0183LinuxServer::Accept() {
+  while ( true ) {
+    int Socket=accept4(ListenSocket, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if ( Socket<0 ) {
+      if ( errno==EINTR || errno==ECONNABORTED ) continue;
+      // Listen socket stays readable, so stop polling it until a client leaves
+      if ( errno==EMFILE || errno==ENFILE || errno==ENOBUFS || errno==ENOMEM ) SetAcceptPaused(true);
+      return;  // EAGAIN
+    }
+
+    tClient *Client=( Clients.size()<MaxClients ? new tClient : 0 );
+    char *Buf=( Client!=0 ? (char *)malloc(BufSize) : 0 );
+    if ( Buf==0 ) {
+      delete Client;
+      close(Socket);
+      continue;
+    }
+
+    int On=1;
+    setsockopt(Socket, IPPROTO_TCP, TCP_NODELAY, &On, sizeof(On));  // buffers are already coalesced
+
+    Client->Socket=Socket;
+    Client->Index=Clients.size();
+    Client->Buf=Buf;
+    Client->Head=0;
+    Client->Len=0;
+    Client->FirstTime=0;
+    Client->WaitWritable=false;
+    Client->InputClosed=false;
+
+    struct epoll_event Event;
+    Event.events=EPOLLIN | EPOLLRDHUP;
+    Event.data.ptr=Client;
+    if ( epoll_ctl(EpollSocket, EPOLL_CTL_ADD, Socket, &Event)<0 ) {
+      free(Buf);
+      delete Client;
+      close(Socket);
+      continue;
+    }
+    Clients.push_back(Client);
+  }
+}
+
+//*****************************************************************************
+void tNMEA0183LinuxServer::SetAcceptPaused(bool Paused) {
+  if ( AcceptPaused==Paused ) return;
+  struct epoll_event Event;
+  Event.events=( Paused ? 0 : (uint32_t)EPOLLIN );
+  Event.data.ptr=0;
+  if ( epoll_ctl(EpollSocket, EPOLL_CTL_MOD, ListenSocket, &Event)==0 ) AcceptPaused=Paused;
+}
+
+//*****************************************************************************
+void tNMEA0183LinuxServer::Remove(tClient *Client) {
+  close(Client->Socket);  // also removes it from epoll
+  tClient *Last=Clients.back();
+  Clients[Client->Index]=Last;
+  Last->Index=Client->Index;
+  Clients.pop_back();
+  free(Client->Buf);
+  delete Client;
+  SetAcceptPaused(false);  // descriptor is free again
+}
+
+//*****************************************************************************
+// Input is not used. Ctrl-C closes the connection, like on the WiFi example.
+// EOF only closes the input, the client may still read.
+void tNMEA0183LinuxServer::Read(tClient *Client) {
+  char Buf[256];
+
+  while ( true ) {
+    ssize_t Len=recv(Client->Socket, Buf, sizeof(Buf), 0);
+    if ( Len>0 ) {
+      if ( memchr(Buf, 0x03, Len)!=0 ) { Remove(Client); return; }
+      continue;
+    }
+    if ( Len==0 ) {
+      Client->InputClosed=true;
+      UpdateEvents(Client);
+      return;
+    }
+    if ( errno==EINTR ) continue;
+    if ( errno==EAGAIN || errno==EWOULDBLOCK ) return;
+    Remove(Client);  // error
+    return;
+  }
+}
+
+//*****************************************************************************
+// EPOLLHUP and EPOLLERR are reported always
+void tNMEA0183LinuxServer::UpdateEvents(tClient *Client) {
+  struct epoll_event Event;
+  Event.events=( Client->InputClosed ? 0 : EPOLLIN | EPOLLRDHUP ) | ( Client->WaitWritable ? (uint32_t)EPOLLOUT : 0 );
+  Event.data.ptr=Client;
+  epoll_ctl(EpollSocket, EPOLL_CTL_MOD, Client->Socket, &Event);
+}
+
+//*****************************************************************************
+void tNMEA0183LinuxServer::SetWaitWritable(tClient *Client, bool Wait) {
+  if ( Client->WaitWritable==Wait ) return;
+  Client->WaitWritable=Wait;
+  UpdateEvents(Client);
+}
+
+//*****************************************************************************
+// Write as much of the buffer as the socket takes. Returns false on error.
+bool tNMEA0183LinuxServer::Flush(tClient *Client) {
+  while ( Client->Len>0 ) {
+    struct iovec Parts[2];
+    size_t First=BufSize-Client->Head;
+    if ( First>Client->Len ) First=Client->Len;
+    Parts[0].iov_base=Client->Buf+Client->Head;
+    Parts[0].iov_len=First;
+    Parts[1].iov_base=Client->Buf;
+    Parts[1].iov_len=Client->Len-First;
+
+    struct msghdr Msg;
+    memset(&Msg, 0, sizeof(Msg));
+    Msg.msg_iov=Parts;
+    Msg.msg_iovlen=( Parts[1].iov_len>0 ? 2 : 1 );
+
+    ssize_t Sent=sendmsg(Client->Socket, &Msg, MSG_NOSIGNAL);
+    if ( Sent<0 ) {
+      if ( errno==EINTR ) continue;
+      if ( errno==EAGAIN || errno==EWOULDBLOCK ) {
+        SetWaitWritable(Client, true);
+        return true;
+      }
+      return false;
+    }
+    Client->Head=(Client->Head+Sent)%BufSize;
+    Client->Len-=Sent;
+  }
+
+  Client->Head=0;
+  SetWaitWritable(Client, false);
+  return true;
+}
+
+//*****************************************************************************
+void tNMEA0183LinuxServer::Send(const char *Text, size_t Len) {
+  if ( Len==0 ) return;
+  uint64_t Time=Now();
+
+  // Backwards, so Remove() moves only already handled clients
+  for (size_t i=Clients.size(); i>0; i--) {
+    tClient *Client=Clients[i-1];
+    if ( Client->Len+Len>BufSize ) { DroppedLines++; continue; }
+
+    if ( Client->Len==0 ) Client->FirstTime=Time;
+    size_t Tail=(Client->Head+Client->Len)%BufSize;
+    size_t First=BufSize-Tail;
+    if ( First>Len ) First=Len;
+    memcpy(Client->Buf+Tail, Text, First);
+    memcpy(Client->Buf, Text+First, Len-First);
+    Client->Len+=Len;
+
+    if ( Client->Len>=FlushSize && !Client->WaitWritable && !Flush(Client) ) Remove(Client);
+  }
+}
+
+//*****************************************************************************
+void tNMEA0183LinuxServer::Poll(int Timeout) {
+  if ( EpollSocket<0 ) {
+    if ( Timeout>0 ) usleep(Timeout*1000);
+    return;
+  }
+
+  struct epoll_event Events[64];
+  int Count=epoll_wait(EpollSocket, Events, 64, Timeout);
+
+  for (int i=0; i<Count; i++) {
+    tClient *Client=(tClient *)Events[i].data.ptr;
+    if ( Client==0 ) { Accept(); continue; }
+    if ( Events[i].events & ( EPOLLERR | EPOLLHUP ) ) { Remove(Client); continue; }
+    if ( Events[i].events & EPOLLOUT ) {
+      if ( !Flush(Client) ) { Remove(Client); continue; }
+    }
+    if ( Events[i].events & ( EPOLLIN | EPOLLRDHUP ) ) Read(Client);  // reads up to EOF
+  }
+
+  uint64_t Time=Now();
+  for (size_t i=Clients.size(); i>0; i--) {
+    tClient *Client=Clients[i-1];
+    if ( Client->Len==0 || Client->WaitWritable || Time-Client->FirstTime<FlushDelay ) continue;
+    if ( !Flush(Client) ) Remove(Client);
+  }
+}
+
+#endif
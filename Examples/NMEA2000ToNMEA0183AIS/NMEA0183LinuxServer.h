@@ -0,0 +1,96 @@
+/*
+NMEA0183LinuxServer.h
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+// TCP server for NMEA0183 lines on Linux, one thread with non-blocking sockets and epoll.
+// Each client has its own output buffer. Lines are collected there and written with
+// one sendmsg() of up to two iovecs, when FlushSize is reached or the oldest byte has
+// waited FlushDelay. A client, which can not take its lines, gets no new ones until its
+// buffer has room again (counted as dropped). Clients, which close their input (e.g.
+// nc -N), keep getting lines until the connection is closed or fails. All functions
+// must be called from the same thread.
+
+#ifndef _NMEA0183LinuxServer_H_
+#define _NMEA0183LinuxServer_H_
+
+#if !defined(ARDUINO) && defined(__linux__)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+//------------------------------------------------------------------------------
+class tNMEA0183LinuxServer {
+protected:
+  struct tClient {
+    int Socket;
+    size_t Index;             // in Clients
+    char *Buf;                // ring of unsent output
+    size_t Head;
+    size_t Len;
+    uint64_t FirstTime;       // [ms] when Buf got its oldest byte
+    bool WaitWritable;        // EPOLLOUT registered
+    bool InputClosed;         // got EOF, EPOLLIN and EPOLLRDHUP are not registered anymore
+  };
+
+  int ListenSocket;
+  int EpollSocket;
+  std::vector<tClient *> Clients;
+  size_t MaxClients;
+  size_t BufSize;
+  size_t FlushSize;
+  unsigned long FlushDelay;
+  uint64_t DroppedLines;
+  bool AcceptPaused;          // out of descriptors, listen socket not in epoll until a client leaves
+
+  static uint64_t Now();
+  static int OpenListenSocket(int Family, uint16_t Port);
+  void Accept();
+  void SetAcceptPaused(bool Paused);
+  void Read(tClient *Client);
+  bool Flush(tClient *Client);
+  void UpdateEvents(tClient *Client);
+  void SetWaitWritable(tClient *Client, bool Wait);
+  void Remove(tClient *Client);
+
+public:
+  tNMEA0183LinuxServer(size_t _MaxClients=4096, size_t _BufSize=16384, size_t _FlushSize=1436, unsigned long _FlushDelay=5);
+  ~tNMEA0183LinuxServer() { Close(); }
+
+  // Listens on IPv6 and IPv4, or only IPv4 if IPv6 is not available. Returns false with errno set on failure.
+  bool Open(uint16_t Port);
+  void Close();
+  bool IsOpen() const { return ListenSocket>=0; }
+
+  // Complete lines to all clients
+  void Send(const char *Text, size_t Len);
+  // Wait up to Timeout [ms] for sockets, accept and remove clients, write buffers which are writable or due
+  void Poll(int Timeout);
+
+  size_t GetClientCount() const { return Clients.size(); }
+  uint64_t GetDroppedCount() const { return DroppedLines; }
+};
+
+#endif
+
+#endif
@@ -7,13 +7,16 @@ NMEA0183/NMEA2000 library. NMEA2000 -> NMEA0183 including AIS TYPE 1, CLASS A
  Extended for AIS Encoding by Ronnie Zeiller
 
    Reads some messages from NMEA2000 and converts them to NMEA0183
-   format to NMEA0183_out (Serial on Arduino or /dev/tnt0 on RPi).
+   format to NMEA0183_out (Serial on Arduino or /dev/tnt0 and TCP port 10110 on RPi).
    Also forwards all NMEA2000 bus messages in Actisense format.
 
    The example is designed for sending N2k data to OpenCPN on RPi with PiCAN2.
    It can be used also on PC with some Arduino/Teensy board to provide
    NMEA0183 (and also NMEA2000) data to PC. Example has been tested on
    RPi3B, ESP32, Arduino DUE, Arduino Mega and Teensy.
+   The AIS tables (target database, ship names, report decimator) take about 2 kB RAM
+   on Arduino Mega, 12 kB on Arduino DUE and Teensy 3.2 and 86 kB on others, see
+   AIS_TABLE_SIZE in NMEA0183AISRegistry.h. Set smaller sizes, if RAM is short.
 
  To use this example you need install also:
    - NMEA2000 library
@@ -44,6 +47,9 @@ NMEA0183/NMEA2000 library. NMEA2000 -> NMEA0183 including AIS TYPE 1, CLASS A
 #define ENABLE_N2K_ON_USB 0       // Schreibt N2k PGNs an Serial (USB)
 #define N2K_TEXTMODE      1       // If 1 -> Text-Mode, 0 -> Actisense Format
 #define ENABLE_NMEA0183_ON_USB 0  // Writes NMEA0183 to Serial (USB)
+// Position reports of a target on NMEA0183_Out at most every ... [ms], 0 = all. Significant changes of
+// course, speed or navigational status are sent at once. Use e.g. 10000 for 38400 baud links.
+const unsigned long NMEA0183AISReportPeriod=0;
 
 #ifdef ARDUINO
 #define NMEA0183_Out_Stream_Speed 115200
@@ -56,10 +62,22 @@ NMEA0183/NMEA2000 library. NMEA2000 -> NMEA0183 including AIS TYPE 1, CLASS A
 #endif
 #else
 #include "NMEA0183LinuxStream.h"
+#include <thread>
+#include <unistd.h>
+#include <stdio.h>
+#include <errno.h>
+#include <NMEA0183AISLineRing.h>
+#include "NMEA0183LinuxServer.h"
 tNMEA0183LinuxStream NMEA0183OutStream("/dev/tnt0");
 tSocketStream ForwardStream("/dev/tnt2");
 #define N2kForward_Stream ForwardStream
 #define NMEA0183_Out_Stream NMEA0183OutStream
+// N2k conversion runs in loop(), writing to NMEA0183_Out_Stream in SendThread(),
+// so conversion does not wait for the output
+tAISLineRing<1024> NMEA0183OutRing;
+// Same lines also to TCP clients, e.g. OpenCPN on other computers
+const uint16_t NMEA0183ServerPort=10110;
+tNMEA0183LinuxServer NMEA0183Server;
 #endif
 
 // Reading serial number depends of used board. BoardSerialNumber module
@@ -72,8 +90,50 @@ uint32_t GetSerialNumber() {
   return ( Sno!=0?Sno:DefaultSerialNumber );
 }
 
+//*****************************************************************************
+// Empty stream input buffer. Ports may get stuck, if they get data in and it will
+// not be read out.
+template <class T> void FlushStreamInput(T &stream) {
+  while ( stream.available() ) stream.read();
+}
+
+#ifdef ARDUINO
 tNMEA0183 NMEA0183_Out;
 tN2kDataToNMEA0183 N2kDataToNMEA0183(&NMEA2000, &NMEA0183_Out);
+const tN2kDataToNMEA0183::tSink NMEA0183OutSink=tN2kDataToNMEA0183::NMEA0183Sink;
+#else
+tN2kDataToNMEA0183 N2kDataToNMEA0183(&NMEA2000, 0);
+const tN2kDataToNMEA0183::tSink NMEA0183OutSink=tN2kDataToNMEA0183::CallbackSink;
+
+#define MAX_NMEA0183_MESSAGE_SIZE 100
+//*****************************************************************************
+// Callback of N2kDataToNMEA0183, runs on the loop() thread
+void SendNMEA0183Message(const tNMEA0183Msg &NMEA0183Msg) {
+  char buf[MAX_NMEA0183_MESSAGE_SIZE+2];
+  if ( !NMEA0183Msg.GetMessage(buf, MAX_NMEA0183_MESSAGE_SIZE) ) return;
+  size_t len=strlen(buf);
+  buf[len++]='\r';
+  buf[len++]='\n';
+  NMEA0183OutRing.Push(buf, len);  // dropped, if SendThread() is behind by the whole ring
+}
+
+//*****************************************************************************
+// Only reader of NMEA0183OutRing and only user of NMEA0183_Out_Stream and NMEA0183Server
+void SendThread() {
+  const char *Text;
+  size_t Len;
+
+  while ( true ) {
+    while ( (Len=NMEA0183OutRing.Front(Text))>0 ) {
+      NMEA0183_Out_Stream.write((const uint8_t *)Text, Len);
+      NMEA0183Server.Send(Text, Len);
+      NMEA0183OutRing.Pop();
+    }
+    FlushStreamInput(NMEA0183_Out_Stream);
+    NMEA0183Server.Poll(1);  // accepts, removes and writes to clients, sleeps 1 ms without socket events
+  }
+}
+#endif
 
 // Set the information for other bus devices, which messages we support
 const unsigned long TransmitMessages[] PROGMEM={0};
@@ -92,15 +152,6 @@ const unsigned long ReceiveMessages[] PROGMEM={/*126992L,*/
                                                 129810L, // AIS Class B "CS" Static Data Report, Part B
                                                 0};
 
-//*****************************************************************************
-// Empty stream input buffer. Ports may get stuck, if they get data in and it will
-// not be read out.
-template <class T> void FlushStreamInput(T &stream) {
-#ifdef ARDUINO
-  while ( stream.available() ) stream.read();
-#endif
-}
-
 //*****************************************************************************
 void setup() {
 
@@ -156,14 +207,23 @@ void setup() {
   NMEA2000.ExtendTransmitMessages(TransmitMessages);
   NMEA2000.ExtendReceiveMessages(ReceiveMessages);
   NMEA2000.AttachMsgHandler(&N2kDataToNMEA0183);
+  N2kDataToNMEA0183.GetAISDecimator().SetPeriod(NMEA0183OutSink, NMEA0183AISReportPeriod);
 
   NMEA2000.Open();
 
+  #ifdef ARDUINO
   #if ENABLE_NMEA0183_ON_USB == 1
     // Setup NMEA0183 ports and handlers
     NMEA0183_Out.SetMessageStream(&NMEA0183_Out_Stream);
     NMEA0183_Out.Open();
   #endif
+  #else
+  N2kDataToNMEA0183.SetSendNMEA0183MessageCallback(SendNMEA0183Message);
+  if ( !NMEA0183Server.Open(NMEA0183ServerPort) ) {  // without server only NMEA0183_Out_Stream is written
+    fprintf(stderr, "NMEA0183 server on port %u not opened: %s\n", (unsigned)NMEA0183ServerPort, strerror(errno));
+  }
+  std::thread(SendThread).detach();
+  #endif
 }
 
 #if defined(__linux__)||defined(__linux)||defined(linux)
@@ -186,7 +246,10 @@ void loop() {
   N2kDataToNMEA0183.Update();
 
   // We need to clear output streams input data to avoid them to get stuck.
+  // On Linux SendThread() does it for NMEA0183_Out_Stream, which it writes.
+  #ifdef ARDUINO
   FlushStreamInput(NMEA0183_Out_Stream);
+  #endif
   #ifdef N2kForward_Stream
   FlushStreamInput(N2kForward_Stream);
   #endif
@@ -47,29 +47,34 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <NMEA0183Messages.h>
 #include <math.h>
 #include <NMEA0183AISMessages.h>
+#include <NMEA0183AISDecoder.h>
 #include <math.h>
 #include <string.h>
 
 const double radToDeg=180.0/M_PI;
 
+//*****************************************************************************
+// Handled PGNs, keep sorted by PGN
+const tN2kDataToNMEA0183::tPGNDispatcher::tEntry tN2kDataToNMEA0183::PGNHandlers[]={
+  { 127250UL, &tN2kDataToNMEA0183::HandleHeading },
+  { 127258UL, &tN2kDataToNMEA0183::HandleVariation },
+  { 128259UL, &tN2kDataToNMEA0183::HandleBoatSpeed },
+  { 128267UL, &tN2kDataToNMEA0183::HandleDepth },
+  { 129025UL, &tN2kDataToNMEA0183::HandlePosition },
+  { 129026UL, &tN2kDataToNMEA0183::HandleCOGSOG },
+  { 129029UL, &tN2kDataToNMEA0183::HandleGNSS },
+  { 129038UL, &tN2kDataToNMEA0183::HandleAISClassAPosReport },      // AIS Class A Position Report, Message Type 1
+  { 129039UL, &tN2kDataToNMEA0183::HandleAISClassBMessage18 },      // AIS Class B Position Report, Message Type 18
+  { 129794UL, &tN2kDataToNMEA0183::HandleAISClassAMessage5 },       // AIS Class A Ship Static and Voyage related data, Message Type 5
+  { 129809UL, &tN2kDataToNMEA0183::HandleAISClassBMessage24A },     // AIS Class B "CS" Static Data Report, Part A
+  { 129810UL, &tN2kDataToNMEA0183::HandleAISClassBMessage24B },     // AIS Class B "CS" Static Data Report, Part B
+  { 130306UL, &tN2kDataToNMEA0183::HandleWind },
+};
+const size_t tN2kDataToNMEA0183::PGNHandlerCount=sizeof(PGNHandlers)/sizeof(PGNHandlers[0]);
+
 //*****************************************************************************
 void tN2kDataToNMEA0183::HandleMsg(const tN2kMsg &N2kMsg) {
-  switch (N2kMsg.PGN) {
-    case 127250UL: HandleHeading(N2kMsg);
-    case 127258UL: HandleVariation(N2kMsg);
-    case 128259UL: HandleBoatSpeed(N2kMsg);
-    case 128267UL: HandleDepth(N2kMsg);
-    case 129025UL: HandlePosition(N2kMsg);
-    case 129026UL: HandleCOGSOG(N2kMsg);
-    case 129029UL: HandleGNSS(N2kMsg);
-    case 130306UL: HandleWind(N2kMsg);
-    // AIS
-    case 129038UL: HandleAISClassAPosReport(N2kMsg); break;   // AIS Class A Position Report, Message Type 1
-    case 129039UL: HandleAISClassBMessage18(N2kMsg); break;   // AIS Class B Position Report, Message Type 18
-    case 129794UL: HandleAISClassAMessage5(N2kMsg);  break;   // AIS Class A Ship Static and Voyage related data, Message Type 5
-    case 129809UL: HandleAISClassBMessage24A(N2kMsg); break;  // AIS Class B "CS" Static Data Report, Part A
-    case 129810UL: HandleAISClassBMessage24B(N2kMsg); break;  // AIS Class B "CS" Static Data Report, Part B
-  }
+  PGNDispatcher.Dispatch(*this, N2kMsg);
 }
 
 //*****************************************************************************
@@ -79,12 +84,63 @@ void tN2kDataToNMEA0183::Update() {
   if ( LastCOGSOGTime+2000<millis() ) { COG=N2kDoubleNA; SOG=N2kDoubleNA; }
   if ( LastPositionTime+4000<millis() ) { Latitude=N2kDoubleNA; Longitude=N2kDoubleNA; }
   if ( LastWindTime+2000<millis() ) { WindSpeed=N2kDoubleNA; WindAngle=N2kDoubleNA; }
+  SendOutput();
+}
+
+//*****************************************************************************
+// Queued lines, highest priority first, as far as the outputs can take them
+void tN2kDataToNMEA0183::SendOutput() {
+  const char *Text;
+  uint32_t Sinks;
+  size_t Len;
+
+  while ( (Len=Output.Front(Text, Sinks))>0 ) {
+    if ( OutputCapacityCallback!=0 && OutputCapacityCallback()<Len ) return;
+    if ( SendNMEA0183SentencesCallback!=0 ) SendNMEA0183SentencesCallback(Text, Sinks);
+    Output.Pop();
+  }
 }
 
 //*****************************************************************************
+// Own ship data
 void tN2kDataToNMEA0183::SendMessage(const tNMEA0183Msg &NMEA0183Msg) {
   if ( pNMEA0183!=0 ) pNMEA0183->SendMessage(NMEA0183Msg);
-  if ( SendNMEA0183MessageCallback!=0 ) SendNMEA0183MessageCallback(NMEA0183Msg);
+  if ( SendNMEA0183SentencesCallback!=0 ) {
+    char Buf[MaxNMEA0183MessageSize+2];
+    if ( !NMEA0183Msg.GetMessage(Buf, MaxNMEA0183MessageSize) ) return;
+    size_t Len=strlen(Buf);
+    Buf[Len++]='\r';
+    Buf[Len++]='\n';
+    Output.Push(tAISOutputQueue::OwnShip, Buf, Len);
+  } else if ( SendNMEA0183MessageCallback!=0 ) {
+    SendNMEA0183MessageCallback(NMEA0183Msg);
+  }
+}
+
+//*****************************************************************************
+void tN2kDataToNMEA0183::SendSentences(const char *Sentences, tAISOutputQueue::tPriority Priority, uint32_t Sinks) {
+  if ( SendNMEA0183SentencesCallback!=0 ) Output.Push(Priority, Sentences, Sinks);
+}
+
+//*****************************************************************************
+// Position report only to the outputs, whose period for the target has elapsed
+// or which have not got a significant change of it yet.
+void tN2kDataToNMEA0183::SendPositionReport(const uint8_t *Bits, uint16_t Length, char Channel) {
+  char Sentence[AISMessage1BufSize];  // same size for Message 18
+
+  AISTargets.UpdatePosition(millis(), Bits, Length);
+
+  uint32_t Sinks=AISDecimator.Pass(millis(), tAISReportDecimator::AllSinks, Bits, Length);
+  if ( Sinks==0 ) return;
+
+  // Only the changed characters of the previous sentence of this target are armored
+  if ( AISPositionSentences.Write(Sentence, sizeof(Sentence), Bits, Length, Channel)==0 ) return;
+  SendSentences(Sentence, tAISOutputQueue::AISPosition, Sinks);
+
+  #ifdef SERIAL_PRINT_AIS_NMEA
+  // Debug Print AIS-NMEA
+  Serial.print(Sentence);
+  #endif
 }
 
 //*****************************************************************************
@@ -251,68 +307,39 @@ void tN2kDataToNMEA0183::SendRMC() {
 //*****************************************************************************
 // 129038 AIS Class A Position Report (Message 1, 2, 3)
 void tN2kDataToNMEA0183::HandleAISClassAPosReport(const tN2kMsg &N2kMsg) {
+  uint8_t Bits[AISPositionPayloadBytes];
+  uint16_t Length;
+  char Channel;
 
-  unsigned char SID;
-  tN2kAISRepeat _Repeat;
-  uint32_t _UserID;  // MMSI
-  double _Latitude;
-  double _Longitude;
-  bool _Accuracy;
-  bool _RAIM;
-  uint8_t _Seconds;
-  double _COG;
-  double _SOG;
-  double _Heading;
-  double _ROT;
-  tN2kAISNavStatus _NavStatus;
-
-  uint8_t _MessageType = 1;
-  tNMEA0183AISMsg NMEA0183AISMsg;
-
-  if ( ParseN2kPGN129038(N2kMsg, SID, _Repeat, _UserID, _Latitude, _Longitude, _Accuracy, _RAIM, _Seconds,
-                          _COG, _SOG, _Heading, _ROT, _NavStatus ) ) {
+  // PGN fields are converted to AIS payload bits directly, without ParseN2kPGN129038 and double values
+  if ( AISTranscodeN2kPosition(Bits, Length, Channel, N2kMsg) ) {
 
     // Debug
     #ifdef SERIAL_PRINT_AIS_FIELDS
-      Serial.println("–––––––––––––––––––––––– Msg 1 ––––––––––––––––––––––––––––––––");
-
-      const double pi=3.1415926535897932384626433832795;
-      const double radToDeg=180.0/pi;
-      const double msTokn=3600.0/1852.0;
-      const double radsToDegMin = 60 * 360.0 / (2 * pi);    // [rad/s -> degree/minute]
-      Serial.print("Repeat: "); Serial.println(_Repeat);
-      Serial.print("UserID: "); Serial.println(_UserID);
-      Serial.print("Latitude: "); Serial.println(_Latitude);
-      Serial.print("Longitude: "); Serial.println(_Longitude);
-      Serial.print("Accuracy: "); Serial.println(_Accuracy);
-      Serial.print("RAIM: "); Serial.println(_RAIM);
-      Serial.print("Seconds: "); Serial.println(_Seconds);
-      Serial.print("COG: "); Serial.println(_COG*radToDeg);
-      Serial.print("SOG: "); Serial.println(_SOG*msTokn);
-      Serial.print("Heading: "); Serial.println(_Heading*radToDeg);
-      Serial.print("ROT: "); Serial.println(_ROT*radsToDegMin);
-      Serial.print("NavStatus: "); Serial.println(_NavStatus);
+      tAISClassAPositionReport Report;
+      if ( AISDecodeClassAPositionReport(Bits, Length, Report) ) {
+        Serial.println("–––––––––––––––––––––––– Msg 1 ––––––––––––––––––––––––––––––––");
+
+        const double pi=3.1415926535897932384626433832795;
+        const double radToDeg=180.0/pi;
+        const double msTokn=3600.0/1852.0;
+        const double radsToDegMin = 60 * 360.0 / (2 * pi);    // [rad/s -> degree/minute]
+        Serial.print("Repeat: "); Serial.println(Report.Repeat);
+        Serial.print("UserID: "); Serial.println(Report.UserID);
+        Serial.print("Latitude: "); Serial.println(Report.Latitude);
+        Serial.print("Longitude: "); Serial.println(Report.Longitude);
+        Serial.print("Accuracy: "); Serial.println(Report.Accuracy);
+        Serial.print("RAIM: "); Serial.println(Report.RAIM);
+        Serial.print("Seconds: "); Serial.println(Report.Seconds);
+        Serial.print("COG: "); Serial.println(Report.COG*radToDeg);
+        Serial.print("SOG: "); Serial.println(Report.SOG*msTokn);
+        Serial.print("Heading: "); Serial.println(Report.Heading*radToDeg);
+        Serial.print("ROT: "); Serial.println(Report.ROT*radsToDegMin);
+        Serial.print("NavStatus: "); Serial.println(Report.NavStatus);
+      }
     #endif
 
-    if ( SetAISClassABMessage1(NMEA0183AISMsg, _MessageType, _Repeat, _UserID, _Latitude, _Longitude, _Accuracy,
-                          _RAIM, _Seconds, _COG, _SOG, _Heading, _ROT, _NavStatus ) ) {
-
-      SendMessage(NMEA0183AISMsg);
-
-      #ifdef SERIAL_PRINT_AIS_NMEA
-        // Debug Print AIS-NMEA
-        Serial.print(NMEA0183AISMsg.GetPrefix());
-        Serial.print(NMEA0183AISMsg.Sender());
-        Serial.print(NMEA0183AISMsg.MessageCode());
-        for (int i=0; i<NMEA0183AISMsg.FieldCount(); i++) {
-          Serial.print(",");
-          Serial.print(NMEA0183AISMsg.Field(i));
-        }
-        char buf[7];
-        sprintf(buf,"*%02X\r\n",NMEA0183AISMsg.GetCheckSum());
-        Serial.print(buf);
-      #endif
-    }
+    SendPositionReport(Bits, Length, Channel);
   }
 }  // end 129038 AIS Class A Position Report Message 1/3
 
@@ -342,8 +369,6 @@ void tN2kDataToNMEA0183::HandleAISClassAMessage5(const tN2kMsg &N2kMsg) {
   tN2kAISTransceiverInformation _AISinfo;
   tN2kAISDTE _DTE;
 
-  tNMEA0183AISMsg NMEA0183AISMsg;
-
   if ( ParseN2kPGN129794(N2kMsg, _MessageID, _Repeat, _UserID, _IMONumber, _Callsign, _CallsignBufSize, _Name, _NameBufSize, _VesselType,
                         _Length, _Beam, _PosRefStbd, _PosRefBow, _ETAdate, _ETAtime, _Draught, _Destination, _DestinationBufSize,
                         _AISversion, _GNSStype, _DTE, _AISinfo) ) {
@@ -371,39 +396,21 @@ void tN2kDataToNMEA0183::HandleAISClassAMessage5(const tN2kMsg &N2kMsg) {
       Serial.println("––––––––––––––––––––––– Msg 5 –––––––––––––––––––––––––––––––––");
     #endif
 
-    if ( SetAISClassAMessage5(NMEA0183AISMsg, _MessageID, _Repeat, _UserID, _IMONumber, _Callsign, _Name, _VesselType,
+    AISTargets.UpdateClassAStatic(millis(), _Repeat, _UserID, _IMONumber, _Callsign, _Name, _VesselType,
                               _Length, _Beam, _PosRefStbd, _PosRefBow, _ETAdate, _ETAtime, _Draught, _Destination,
-                              _GNSStype, _DTE ) ) {
+                              _GNSStype, _DTE);
 
-      SendMessage( NMEA0183AISMsg.BuildMsg5Part1(NMEA0183AISMsg) );
+    // Unchanged static data is taken from AISStaticSentences without encoding
+    char Sentences[AISMessage5BufSize];
+    if ( EncodeAISClassAMessage5To(AISContext, Sentences, sizeof(Sentences), _MessageID, _Repeat, _UserID, _IMONumber, _Callsign, _Name,
+                                   _VesselType, _Length, _Beam, _PosRefStbd, _PosRefBow, _ETAdate, _ETAtime, _Draught, _Destination,
+                                   _GNSStype, _DTE )>0 ) {
 
-      #ifdef SERIAL_PRINT_AIS_NMEA
-      // Debug Print AIS-NMEA Message Type 5, Part 1
-      char buf[7];
-      Serial.print(NMEA0183AISMsg.GetPrefix());
-      Serial.print(NMEA0183AISMsg.Sender());
-      Serial.print(NMEA0183AISMsg.MessageCode());
-      for (int i=0; i<NMEA0183AISMsg.FieldCount(); i++) {
-        Serial.print(",");
-        Serial.print(NMEA0183AISMsg.Field(i));
-      }
-      sprintf(buf,"*%02X\r\n",NMEA0183AISMsg.GetCheckSum());
-      Serial.print(buf);
-      #endif
-
-      SendMessage( NMEA0183AISMsg.BuildMsg5Part2(NMEA0183AISMsg) );
+      SendSentences(Sentences, tAISOutputQueue::AISStatic);
 
       #ifdef SERIAL_PRINT_AIS_NMEA
-      // Print AIS-NMEA Message Type 5, Part 2
-      Serial.print(NMEA0183AISMsg.GetPrefix());
-      Serial.print(NMEA0183AISMsg.Sender());
-      Serial.print(NMEA0183AISMsg.MessageCode());
-      for (int i=0; i<NMEA0183AISMsg.FieldCount(); i++) {
-        Serial.print(",");
-        Serial.print(NMEA0183AISMsg.Field(i));
-      }
-      sprintf(buf,"*%02X\r\n",NMEA0183AISMsg.GetCheckSum());
-      Serial.print(buf);
+      // Debug Print AIS-NMEA Message Type 5, Part 1 and 2
+      Serial.print(Sentences);
       #endif
     }
   }
@@ -413,47 +420,12 @@ void tN2kDataToNMEA0183::HandleAISClassAMessage5(const tN2kMsg &N2kMsg) {
 //*****************************************************************************
 // 129039 AIS Class B Position Report (Message 18)
 void tN2kDataToNMEA0183::HandleAISClassBMessage18(const tN2kMsg &N2kMsg) {
-  uint8_t _MessageID;
-  tN2kAISRepeat _Repeat;
-  uint32_t _UserID;  // MMSI
-  double _Latitude;
-  double _Longitude;
-  bool _Accuracy;
-  bool _RAIM;
-  uint8_t _Seconds;
-  double _COG;
-  double _SOG;
-  double _Heading;
-  tN2kAISUnit _Unit;
-  bool _Display, _DSC, _Band, _Msg22, _State;
-  tN2kAISMode _Mode;
-  tN2kAISTransceiverInformation _AISTransceiverInformation;
+  uint8_t Bits[AISPositionPayloadBytes];
+  uint16_t Length;
+  char Channel;
 
-  if ( ParseN2kPGN129039(N2kMsg, _MessageID, _Repeat, _UserID, _Latitude, _Longitude, _Accuracy, _RAIM,
-                     _Seconds, _COG, _SOG, _AISTransceiverInformation, _Heading, _Unit, _Display, _DSC, _Band, _Msg22, _Mode, _State) ) {
-
-    tNMEA0183AISMsg NMEA0183AISMsg;
-
-    if ( SetAISClassBMessage18(NMEA0183AISMsg, _MessageID, _Repeat, _UserID, _Latitude, _Longitude, _Accuracy, _RAIM,
-                     _Seconds, _COG, _SOG, _Heading, _Unit, _Display, _DSC, _Band, _Msg22, _Mode, _State) ) {
-
-      SendMessage(NMEA0183AISMsg);
-
-      #ifdef SERIAL_PRINT_AIS_NMEA
-      // Debug Print AIS-NMEA
-      Serial.print(NMEA0183AISMsg.GetPrefix());
-      Serial.print(NMEA0183AISMsg.Sender());
-      Serial.print(NMEA0183AISMsg.MessageCode());
-      for (int i=0; i<NMEA0183AISMsg.FieldCount(); i++) {
-        Serial.print(",");
-        Serial.print(NMEA0183AISMsg.Field(i));
-      }
-      char buf[7];
-      sprintf(buf,"*%02X\r\n",NMEA0183AISMsg.GetCheckSum());
-      Serial.print(buf);
-      #endif
-    }
-  }
+  // PGN fields are converted to AIS payload bits directly, without ParseN2kPGN129039 and double values
+  if ( AISTranscodeN2kPosition(Bits, Length, Channel, N2kMsg) ) SendPositionReport(Bits, Length, Channel);
   return;
 }
 
@@ -469,14 +441,24 @@ void tN2kDataToNMEA0183::HandleAISClassBMessage24A(const tN2kMsg &N2kMsg) {
 
   if ( ParseN2kPGN129809 (N2kMsg, _MessageID, _Repeat, _UserID, _Name, _NameBufSize) ) {
 
-    tNMEA0183AISMsg NMEA0183AISMsg;
-    if ( SetAISClassBMessage24PartA(NMEA0183AISMsg, _MessageID, _Repeat, _UserID, _Name) ) {}
+    AISTargets.UpdateClassBStaticPartA(millis(), _Repeat, _UserID, _Name);
+
+    char Sentences[AISMessage24PartBufSize];
+    if ( EncodeAISClassBMessage24PartATo(AISContext, Sentences, sizeof(Sentences), _MessageID, _Repeat, _UserID, _Name)>0 ) {
+
+      SendSentences(Sentences, tAISOutputQueue::AISStatic);
+
+      #ifdef SERIAL_PRINT_AIS_NMEA
+      // Debug Print AIS-NMEA Message Type 24, Part A
+      Serial.print(Sentences);
+      #endif
+    }
   }
   return;
 }
 
 //*****************************************************************************
-// PGN 129810 AIS Class B "CS" Static Data Report, Part B -> AIS Message 24 (2 Parts)
+// PGN 129810 AIS Class B "CS" Static Data Report, Part B -> AIS Message 24 Part B
 void tN2kDataToNMEA0183::HandleAISClassBMessage24B(const tN2kMsg &N2kMsg) {
 
   uint8_t _MessageID;
@@ -514,41 +496,18 @@ void tN2kDataToNMEA0183::HandleAISClassBMessage24B(const tN2kMsg &N2kMsg) {
     Serial.println("––––––––––––––––––––––– Msg 24 ––––––––––––––––––––––––––––––––");
     #endif
 
-    tNMEA0183AISMsg NMEA0183AISMsg;
+    AISTargets.UpdateClassBStaticPartB(millis(), _Repeat, _UserID, _VesselType, _Vendor, _Callsign,
+                          _Length, _Beam, _PosRefStbd, _PosRefBow, _MothershipID);
 
-    if ( SetAISClassBMessage24(NMEA0183AISMsg, _MessageID, _Repeat, _UserID, _VesselType, _Vendor, _Callsign,
-                          _Length, _Beam, _PosRefStbd, _PosRefBow, _MothershipID ) ) {
+    char Sentences[AISMessage24PartBufSize];
+    if ( EncodeAISClassBMessage24PartBTo(AISContext, Sentences, sizeof(Sentences), _MessageID, _Repeat, _UserID, _VesselType, _Vendor, _Callsign,
+                                         _Length, _Beam, _PosRefStbd, _PosRefBow, _MothershipID )>0 ) {
 
-      //SendMessage( NMEA0183AISMsg.BuildMsg24PartA() );
-      SendMessage( NMEA0183AISMsg.BuildMsg24PartA(NMEA0183AISMsg) );
+      SendSentences(Sentences, tAISOutputQueue::AISStatic);
 
       #ifdef SERIAL_PRINT_AIS_NMEA
-      // Debug Print AIS-NMEA
-      char buf[7];
-      Serial.print(NMEA0183AISMsg.GetPrefix());
-      Serial.print(NMEA0183AISMsg.Sender());
-      Serial.print(NMEA0183AISMsg.MessageCode());
-      for (int i=0; i<NMEA0183AISMsg.FieldCount(); i++) {
-        Serial.print(",");
-        Serial.print(NMEA0183AISMsg.Field(i));
-      }
-      sprintf(buf,"*%02X\r\n",NMEA0183AISMsg.GetCheckSum());
-      Serial.print(buf);
-      #endif
-
-      //SendMessage( NMEA0183AISMsg.BuildMsg24PartB() );
-      SendMessage( NMEA0183AISMsg.BuildMsg24PartB(NMEA0183AISMsg) );
-
-      #ifdef SERIAL_PRINT_AIS_NMEA
-      Serial.print(NMEA0183AISMsg.GetPrefix());
-      Serial.print(NMEA0183AISMsg.Sender());
-      Serial.print(NMEA0183AISMsg.MessageCode());
-      for (int i=0; i<NMEA0183AISMsg.FieldCount(); i++) {
-        Serial.print(",");
-        Serial.print(NMEA0183AISMsg.Field(i));
-      }
-      sprintf(buf,"*%02X\r\n",NMEA0183AISMsg.GetCheckSum());
-      Serial.print(buf);
+      // Debug Print AIS-NMEA Message Type 24, Part B
+      Serial.print(Sentences);
       #endif
     }
   }
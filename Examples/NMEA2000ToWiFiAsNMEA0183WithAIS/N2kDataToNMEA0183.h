@@ -24,14 +24,24 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <NMEA0183.h>
 #include <NMEA2000.h>
+#include <NMEA0183AISMessages.h>
+#include <NMEA0183AISTargets.h>
+#include <NMEA0183AISSentenceCache.h>
+#include <NMEA0183AISDecimator.h>
+#include <NMEA0183AISPGNDispatcher.h>
+#include <NMEA0183AISOutputQueue.h>
 
 //------------------------------------------------------------------------------
 class tN2kDataToNMEA0183 : public tNMEA2000::tMsgHandler {
 public:
   using tSendNMEA0183MessageCallback=void (*)(const tNMEA0183Msg &NMEA0183Msg);
+  // Complete "...\r\n" lines for the outputs (sinks of tAISReportDecimator) with bit set in Sinks
+  using tSendNMEA0183SentencesCallback=void (*)(const char *Sentences, uint32_t Sinks);
+  using tOutputCapacityCallback=size_t (*)();  // bytes the outputs can take now without blocking
 
 protected:
   static const unsigned long RMCPeriod=1000;
+  static const size_t MaxNMEA0183MessageSize=100;
   double Latitude;
   double Longitude;
   double Altitude;
@@ -52,7 +62,15 @@ protected:
   unsigned long NextRMCSend;
 
   tNMEA0183 *pNMEA0183;
+  tAISEncoderContext AISContext;  // own ship names and sequential IDs for this bus
+  tAISTargetDB AISTargets;        // latest position and static data of received targets
+  tAISStaticSentenceCache AISStaticSentences;  // encoded Message 5 and 24 for catch-up of new clients
+  tAISPositionSentenceCache AISPositionSentences;  // last position report sentence per target
+  tAISReportDecimator AISDecimator;  // position reports per target and output for slow links
+  tAISOutputQueue Output;         // lines for SendNMEA0183SentencesCallback by priority
   tSendNMEA0183MessageCallback SendNMEA0183MessageCallback;
+  tSendNMEA0183SentencesCallback SendNMEA0183SentencesCallback;
+  tOutputCapacityCallback OutputCapacityCallback;
 
 protected:
   void HandleHeading(const tN2kMsg &N2kMsg); // 127250
@@ -72,14 +90,27 @@ protected:
   void HandleAISClassBMessage24A(const tN2kMsg &N2kMsg);  // 129809 AIS Class B "CS" Static Data Report, Part A
   void HandleAISClassBMessage24B(const tN2kMsg &N2kMsg);  // 129810 AIS Class B "CS" Static Data Report, Part B
 
+  // Handlers by PGN, sorted by PGN
+  typedef tAISPGNDispatcher<tN2kDataToNMEA0183> tPGNDispatcher;
+  static const tPGNDispatcher::tEntry PGNHandlers[];
+  static const size_t PGNHandlerCount;
+  tPGNDispatcher PGNDispatcher;
+
   void SetNextRMCSend() { NextRMCSend=millis()+RMCPeriod; }
   void SendRMC();
   void SendMessage(const tNMEA0183Msg &NMEA0183Msg);
+  void SendSentences(const char *Sentences, tAISOutputQueue::tPriority Priority, uint32_t Sinks=tAISReportDecimator::AllSinks);
+  // Position report payload to the target database and, decimated, to the outputs on Channel
+  void SendPositionReport(const uint8_t *Bits, uint16_t Length, char Channel);
 
 public:
-  tN2kDataToNMEA0183(tNMEA2000 *_pNMEA2000, tNMEA0183 *_pNMEA0183) : tNMEA2000::tMsgHandler(0,_pNMEA2000) {
+  tN2kDataToNMEA0183(tNMEA2000 *_pNMEA2000, tNMEA0183 *_pNMEA0183) : tNMEA2000::tMsgHandler(0,_pNMEA2000), PGNDispatcher(PGNHandlers, PGNHandlerCount) {
     SendNMEA0183MessageCallback=0;
+    SendNMEA0183SentencesCallback=0;
+    OutputCapacityCallback=0;
     pNMEA0183=_pNMEA0183;
+    AISContext.SentenceCache=&AISStaticSentences;  // unchanged Message 5 and 24 are not encoded again
+    AISContext.PositionCache=&AISPositionSentences;  // position reports patch the previous sentence
     Latitude=N2kDoubleNA; Longitude=N2kDoubleNA; Altitude=N2kDoubleNA;
     Variation=N2kDoubleNA; Heading=N2kDoubleNA; COG=N2kDoubleNA; SOG=N2kDoubleNA;
     SecondsSinceMidnight=N2kDoubleNA; DaysSince1970=N2kUInt16NA;
@@ -94,5 +125,21 @@ public:
   void SetSendNMEA0183MessageCallback(tSendNMEA0183MessageCallback _SendNMEA0183MessageCallback) {
     SendNMEA0183MessageCallback=_SendNMEA0183MessageCallback;
   }
+  // AIS messages are sent only with this callback. If it is set, all other messages go also through
+  // the output queue to it instead of to SendNMEA0183MessageCallback.
+  void SetSendNMEA0183SentencesCallback(tSendNMEA0183SentencesCallback _SendNMEA0183SentencesCallback) {
+    SendNMEA0183SentencesCallback=_SendNMEA0183SentencesCallback;
+  }
+  // Output queue is sent on Update() as far as this callback allows, all at once without it
+  void SetOutputCapacityCallback(tOutputCapacityCallback _OutputCapacityCallback) {
+    OutputCapacityCallback=_OutputCapacityCallback;
+  }
   void Update();
+  void SendOutput();
+  const tAISTargetDB &GetAISTargets() const { return AISTargets; }
+  const tAISStaticSentenceCache &GetAISStaticSentences() const { return AISStaticSentences; }
+  // Set periods per output here, see SetSendNMEA0183SentencesCallback
+  tAISReportDecimator &GetAISDecimator() { return AISDecimator; }
+  // Drop policy, limit and counters of the output queue
+  tAISOutputQueue &GetOutput() { return Output; }
 };
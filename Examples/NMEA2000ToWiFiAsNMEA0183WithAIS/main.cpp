@@ -3,6 +3,8 @@ Demo: NMEA2000 library. Sends NMEA2000 to WiFi in NMEA0183 format, including AIS
 Example from Timo Lappalainen, extended by Ronnie Zeiller
 
 The code has been tested with ESP32.
+The AIS tables (target database, sentence caches, ship names, report decimator) take
+about 125 kB RAM, see AIS_TABLE_SIZE in NMEA0183AISRegistry.h.
 
   This code is free software; you can redistribute it and/or
   modify it under the terms of the GNU Lesser General Public
@@ -45,12 +47,78 @@ const char *password = "Passphrase";
 const uint16_t ServerPort=2222; // Define the port, where served sends data. Use this e.g. on OpenCPN
 const char *ServerIP="192.168.1.100"; // Define the IP, what server will use. This has to be within your local network. Leave empty for DHCP
 const size_t MaxClients=10;
+const unsigned long CatchUpPeriod=10; // [ms] between static data bursts to new clients
+const uint16_t CatchUpTargets=8;      // targets per burst, so 128 cached targets take 160 ms
+// Position reports of a target at most every ... [ms], 0 = all. Significant changes of course, speed
+// or navigational status are sent at once. Use e.g. 10000 for clients on slow links.
+const unsigned long ClientAISReportPeriod=0;
+const unsigned long USBAISReportPeriod=0;
+// Outputs of tAISReportDecimator: clients get 0 ... MaxClients-1, USB is the next
+const uint8_t USBSink=MaxClients;
+static_assert(USBSink<AIS_DECIMATOR_SINKS, "AIS_DECIMATOR_SINKS too small for MaxClients");
+// Output is sent as far as USB and the clients can take it without blocking, see OutputCapacity().
+// Own ship data is sent first, then AIS position reports and static data, the rest waits in the
+// output queue or is dropped from it when it is full. A client, which took nothing for
+// ClientStallTime, does not hold back the others; it drops what does not fit.
+// OutputRate limits output additionally to [bytes/s], 0 = no limit.
+const unsigned long OutputRate=0;
+const size_t OutputBurst=1024;        // [bytes] sent at once after idle time, at least longest queued entry
+const unsigned long ClientStallTime=1000; // [ms]
+// Output to a client is collected and written at once, when ClientBufferSize is reached or
+// the oldest part waited ClientFlushDelay. So a TCP segment carries many sentences instead of one.
+// A client, which does not take its output, gets new sentences dropped until there is room again.
+const size_t ClientBufferSize=1436;   // [bytes] about one TCP segment
+const unsigned long ClientFlushDelay=5; // [ms]
 
 bool ResetWiFiSettings=true; // If you have tested other code in your module, it may have saved settings and have difficulties to make connection.
 
 WiFiServer server(ServerPort, MaxClients);
 
-using tWiFiClientPtr = std::shared_ptr<WiFiClient>;
+// New clients get cached Message 5 and 24 of all known targets first (catch-up)
+struct tClient {
+  WiFiClient Client;
+  uint16_t CatchUpSlot;  // next slot of AIS static sentence cache to send
+  uint8_t Sink;          // of AIS position report decimator
+
+  char OutBuf[ClientBufferSize];
+  size_t OutLen;
+  unsigned long OutTime;  // when OutBuf got its first byte or was last written out in part
+
+  tClient(WiFiClient &_Client, uint8_t _Sink) : Client(_Client), CatchUpSlot(0), Sink(_Sink), OutLen(0), OutTime(0) {}
+  bool CatchingUp() const { return CatchUpSlot<tAISStaticSentenceCache::Capacity; }
+
+  size_t Room() const { return sizeof(OutBuf)-OutLen; }
+  // Bytes Write() takes now without dropping
+  size_t Capacity() {
+    int Free=Client.availableForWrite();
+    return Room()+( Free>0 ? ( (size_t)Free<OutLen ? (size_t)Free : OutLen ) : 0 );
+  }
+  bool Stalled() const { return OutLen>0 && millis()-OutTime>=ClientStallTime; }
+  // Text are complete lines. If they do not fit behind the unwritten output, the client
+  // falls behind and they are dropped as a whole.
+  void Write(const char *Text, size_t Len) {
+    if ( Len>Room() ) Flush();
+    if ( Len>Room() ) return;
+    if ( OutLen==0 ) OutTime=millis();
+    memcpy(OutBuf+OutLen, Text, Len);
+    OutLen+=Len;
+  }
+  // Write as much as the client takes without blocking. The unwritten tail stays in OutBuf
+  // and is retried by FlushClients(), since it is still due.
+  void Flush() {
+    if ( OutLen==0 ) return;
+    int Free=Client.availableForWrite();
+    if ( Free<=0 ) return;
+    size_t Written=Client.write((const uint8_t *)OutBuf, ( (size_t)Free<OutLen ? (size_t)Free : OutLen ));
+    if ( Written==0 || Written>OutLen ) return;
+    OutLen-=Written;
+    memmove(OutBuf, OutBuf+Written, OutLen);
+    OutTime=millis();
+  }
+  bool FlushDue() const { return OutLen>0 && millis()-OutTime>=ClientFlushDelay; }
+};
+
+using tWiFiClientPtr = std::shared_ptr<tClient>;
 LinkedList<tWiFiClientPtr> clients;
 
 tN2kDataToNMEA0183 tN2kDataToNMEA0183(&NMEA2000, 0);
@@ -83,12 +151,14 @@ void LedOn(unsigned long OnTime);
 void UpdateLedState();
 
 // Forward declarations NMEA
-void SendNMEA0183Message(const tNMEA0183Msg &NMEA0183Msg);
+void SendNMEA0183Sentences(const char *Sentences, uint32_t Sinks);
+size_t OutputCapacity();
 void InitNMEA2000();
-void SendBufToClients(const char *buf);
 
 // Forward declarations Webserver
 void CheckConnections();
+void SendCatchUp();
+void FlushClients();
 
 #include <nvs.h>
 #include <nvs_flash.h>
@@ -156,8 +226,10 @@ void setup() {
 void loop() {
 
   CheckConnections();
+  SendCatchUp();
   NMEA2000.ParseMessages();
   tN2kDataToNMEA0183.Update();
+  FlushClients();
 
   // Dummy to empty input buffer to avoid board to stuck with e.g. NMEA Reader
   if ( Serial.available() ) {
@@ -221,42 +293,94 @@ void InitNMEA2000() {
   // With this the library calls tN2kDataToNMEA0183::HandleMsg(const tN2kMsg &N2kMsg) on NMEA2000.ParseMessages() when message arrives.
   NMEA2000.AttachMsgHandler(&tN2kDataToNMEA0183);
 
-  tN2kDataToNMEA0183.SetSendNMEA0183MessageCallback(SendNMEA0183Message);
+  tN2kDataToNMEA0183.SetSendNMEA0183SentencesCallback(SendNMEA0183Sentences);
+  tN2kDataToNMEA0183.SetOutputCapacityCallback(OutputCapacity);
+  tN2kDataToNMEA0183.GetAISDecimator().SetPeriod(USBSink, USBAISReportPeriod);
 
   NMEA2000.Open();
 }
 
-#define MAX_NMEA0183_MESSAGE_SIZE 100
 //*****************************************************************************
-void SendNMEA0183Message(const tNMEA0183Msg &NMEA0183Msg) {
-  char buf[MAX_NMEA0183_MESSAGE_SIZE];
-  if ( !NMEA0183Msg.GetMessage(buf, MAX_NMEA0183_MESSAGE_SIZE) ) return;
-  SendBufToClients(buf);
+// Output budget for OutputRate in [bytes/1000]
+unsigned long OutputBudget=0;
+unsigned long LastOutputBudgetTime=0;
+
+size_t OutputRateBudget() {
+  unsigned long Now=millis();
+  unsigned long Elapsed=Now-LastOutputBudgetTime;
+  if ( Elapsed>1000 ) Elapsed=1000;
+  OutputBudget+=Elapsed*OutputRate;
+  LastOutputBudgetTime=Now;
+  if ( OutputBudget>OutputBurst*1000 ) OutputBudget=OutputBurst*1000;
+  return OutputBudget/1000;
+}
+
+//*****************************************************************************
+// Bytes all outputs can take now: the least of USB and of the clients, which are not stalled
+size_t OutputCapacity() {
+  size_t Capacity=( OutputRate>0 ? OutputRateBudget() : (size_t)-1 );
+
   #if ENABLE_NMEA0183_ON_USB == 1
-       Serial.println(buf);
+    int Free=Serial.availableForWrite();
+    if ( Free>=0 && (size_t)Free<Capacity ) Capacity=Free;
   #endif
+  for (auto it=clients.begin(); it!=clients.end(); it++) {
+    if ( (*it)==NULL || !(*it)->Client.connected() || (*it)->Stalled() ) continue;
+    size_t ClientCapacity=(*it)->Capacity();
+    if ( ClientCapacity<Capacity ) Capacity=ClientCapacity;
+  }
+  return Capacity;
 }
 
-//***********************  WEBSERVER  *****************************************
-// NMEA0183 Sätze an alle Clients senden
-void SendBufToClients(const char *buf) {
+//*****************************************************************************
+// Complete lines with CR LF, e.g. AIS Message 5 with both sentences, to clients
+// and USB with their bit set in Sinks. All NMEA0183 output comes here from the output queue.
+void SendNMEA0183Sentences(const char *Sentences, uint32_t Sinks) {
+  size_t Len=strlen(Sentences);
+
+  if ( OutputRate>0 ) OutputBudget=( OutputBudget>Len*1000 ? OutputBudget-Len*1000 : 0 );
+
   for (auto it=clients.begin() ;it!=clients.end(); it++) {
-    if ( (*it)!=NULL && (*it)->connected() ) {
-      (*it)->println(buf);
+    if ( (*it)!=NULL && (*it)->Client.connected() && ( Sinks & ((uint32_t)1<<(*it)->Sink) )!=0 ) {
+      (*it)->Write(Sentences, Len);
     }
   }
+  #if ENABLE_NMEA0183_ON_USB == 1
+    if ( ( Sinks & ((uint32_t)1<<USBSink) )!=0 ) Serial.print(Sentences);
+  #endif
+}
+
+//***********************  WEBSERVER  *****************************************
+// Lowest decimator sink not used by a client, MaxClients if all are used
+uint8_t FreeSink() {
+  uint32_t Used=0;
+  for (auto it=clients.begin(); it!=clients.end(); it++) {
+    if ( (*it)!=NULL ) Used|=(uint32_t)1<<(*it)->Sink;
+  }
+  uint8_t Sink=0;
+  while ( Sink<MaxClients && ( Used & ((uint32_t)1<<Sink) )!=0 ) Sink++;
+  return Sink;
 }
 
 //*****************************************************************************
 void AddClient(WiFiClient &client) {
+  uint8_t Sink=FreeSink();
+  if ( Sink>=MaxClients ) {
+    Serial.println("Too many clients.");
+    client.stop();
+    return;
+  }
   Serial.println("New Client.");
-  clients.push_back(tWiFiClientPtr(new WiFiClient(client)));
+  // New client gets the next position report of each target
+  tN2kDataToNMEA0183.GetAISDecimator().ResetSink(Sink);
+  tN2kDataToNMEA0183.GetAISDecimator().SetPeriod(Sink, ClientAISReportPeriod);
+  clients.push_back(tWiFiClientPtr(new tClient(client, Sink)));
 }
 
 //*****************************************************************************
 void StopClient(LinkedList<tWiFiClientPtr>::iterator &it) {
   Serial.println("Client Disconnected.");
-  (*it)->stop();
+  (*it)->Client.stop();
   it = clients.erase(it);
 }
 
@@ -268,11 +392,11 @@ void CheckConnections() {
 
   for (auto it = clients.begin(); it != clients.end(); it++) {
     if ( (*it) != NULL ) {
-      if ( !(*it)->connected() ) {
+      if ( !(*it)->Client.connected() ) {
         StopClient(it);
       } else {
-        if ( (*it)->available() ) {
-          char c = (*it)->read();
+        if ( (*it)->Client.available() ) {
+          char c = (*it)->Client.read();
           if ( c == 0x03 ) StopClient(it); // Close connection by ctrl-c
         }
       }
@@ -281,3 +405,37 @@ void CheckConnections() {
     }
   }
 }
+
+//*****************************************************************************
+// Send cached static data of some targets to each new client. Sentences are
+// complete lines, groups of Message 5 are sent together, so live data can be
+// sent in between. A client without room in its buffer continues on next call.
+void SendCatchUp() {
+  static unsigned long LastCatchUp=0;
+
+  if ( millis()-LastCatchUp<CatchUpPeriod ) return;
+  LastCatchUp=millis();
+
+  const tAISStaticSentenceCache &Cache=tN2kDataToNMEA0183.GetAISStaticSentences();
+
+  for (auto it=clients.begin(); it!=clients.end(); it++) {
+    if ( (*it)==NULL || !(*it)->Client.connected() ) continue;
+    tClient &Client=**it;
+    for (uint16_t Sent=0; Sent<CatchUpTargets && Client.CatchingUp(); Client.CatchUpSlot++) {
+      if ( !Cache.IsUsed(Client.CatchUpSlot) ) continue;
+      const tAISStaticSentences &Sentences=Cache.GetAt(Client.CatchUpSlot);
+      if ( Sentences.GetLength()>Client.Room() ) Client.Flush();
+      if ( Sentences.GetLength()>Client.Room() ) break;
+      Client.Write(Sentences.GetText(), Sentences.GetLength());
+      Sent++;
+    }
+  }
+}
+
+//*****************************************************************************
+// Write out client buffers, which have waited ClientFlushDelay
+void FlushClients() {
+  for (auto it=clients.begin(); it!=clients.end(); it++) {
+    if ( (*it)!=NULL && (*it)->Client.connected() && (*it)->FlushDue() ) (*it)->Flush();
+  }
+}
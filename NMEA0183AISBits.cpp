@@ -0,0 +1,229 @@
+/*
+NMEA0183AISBits.cpp
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "NMEA0183AISBits.h"
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+const char AISArmorChars[64] = {
+  '0','1','2','3','4','5','6','7','8','9',':',';','<','=','>','?',
+  '@','A','B','C','D','E','F','G','H','I','J','K','L','M','N','O',
+  'P','Q','R','S','T','U','V','W','`','a','b','c','d','e','f','g',
+  'h','i','j','k','l','m','n','o','p','q','r','s','t','u','v','w'
+};
+
+// Payload character -> 6-bit value, 255 = not a payload character
+static const uint8_t AISDearmorValues[256] = {
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+    0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,
+   16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+   32, 33, 34, 35, 36, 37, 38, 39,255,255,255,255,255,255,255,255,
+   40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55,
+   56, 57, 58, 59, 60, 61, 62, 63,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255
+};
+
+// 6-bit value -> text character
+static const char AISTextChars[] = "@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_ !\"#$%&\'()*+,-./0123456789:;<=>?";
+
+// ASCII -> 6-bit text value. Lowercase letters are taken as uppercase, all characters
+// not in AISTextChars become "@" (0).
+constexpr uint8_t AISTextCode(uint8_t c) {
+  return ( c>=32 && c<64 ? c : ( c>=64 && c<96 ? c-64 : ( c>='a' && c<='z' ? c-96 : 0 ) ) );
+}
+
+#define AIS_TEXT_CODES4(c) AISTextCode(c),AISTextCode(c+1),AISTextCode(c+2),AISTextCode(c+3)
+#define AIS_TEXT_CODES16(c) AIS_TEXT_CODES4(c),AIS_TEXT_CODES4(c+4),AIS_TEXT_CODES4(c+8),AIS_TEXT_CODES4(c+12)
+#define AIS_TEXT_CODES64(c) AIS_TEXT_CODES16(c),AIS_TEXT_CODES16(c+16),AIS_TEXT_CODES16(c+32),AIS_TEXT_CODES16(c+48)
+static constexpr uint8_t AISTextCodes[256] = {
+  AIS_TEXT_CODES64(0), AIS_TEXT_CODES64(64), AIS_TEXT_CODES64(128), AIS_TEXT_CODES64(192)
+};
+#undef AIS_TEXT_CODES64
+#undef AIS_TEXT_CODES16
+#undef AIS_TEXT_CODES4
+
+static_assert(AISTextCodes['@']==0 && AISTextCodes['A']==1 && AISTextCodes['a']==1 && AISTextCodes['z']==26 &&
+              AISTextCodes[' ']==32 && AISTextCodes['?']==63 && AISTextCodes['`']==0 && AISTextCodes[0xc4]==0,
+              "AIS text table");
+
+#if defined(__SSSE3__)
+//*****************************************************************************
+// 12 bytes in each 128 bit lane -> 16 6-bit values, one per byte.
+// Same bit order as base64, so we use the well known multiply-shift method:
+// bytes [a b c] are shuffled to [b a c b], then the four 6-bit groups are
+// moved in place with mulhi/mullo.
+static inline __m128i AISUnpack6(__m128i in) {
+  in=_mm_shuffle_epi8(in, _mm_set_epi8(10,11,9,10, 7,8,6,7, 4,5,3,4, 1,2,0,1));
+  __m128i t0=_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+  __m128i t1=_mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  __m128i t2=_mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+  __m128i t3=_mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  return _mm_or_si128(t1, t3);
+}
+
+// 0...39 -> +48, 40...63 -> +56
+static inline __m128i AISArmor6(__m128i v) {
+  __m128i hi=_mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(39)), _mm_set1_epi8(8));
+  return _mm_add_epi8(v, _mm_add_epi8(hi, _mm_set1_epi8(48)));
+}
+#endif
+
+#if defined(__AVX2__)
+static inline __m256i AISUnpack6x2(__m256i in) {
+  in=_mm256_shuffle_epi8(in, _mm256_set_epi8(10,11,9,10, 7,8,6,7, 4,5,3,4, 1,2,0,1,
+                                             10,11,9,10, 7,8,6,7, 4,5,3,4, 1,2,0,1));
+  __m256i t0=_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+  __m256i t1=_mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+  __m256i t2=_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+  __m256i t3=_mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+  return _mm256_or_si256(t1, t3);
+}
+
+static inline __m256i AISArmor6x2(__m256i v) {
+  __m256i hi=_mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(39)), _mm256_set1_epi8(8));
+  return _mm256_add_epi8(v, _mm256_add_epi8(hi, _mm256_set1_epi8(48)));
+}
+#endif
+
+//*****************************************************************************
+uint16_t AISArmorBits(char *Dst, const uint8_t *Bits, uint16_t Start, uint16_t Length) {
+  uint16_t nChars=(Length+5)/6;
+  uint16_t i=0;
+
+  if ( (Start & 7)==0 ) {
+    const uint8_t *p=Bits+(Start>>3);
+    uint16_t iByte=0;
+    uint16_t nFull=Length/6;   // characters without padding
+
+#if defined(__SSSE3__)
+    // Bytes we are allowed to read. Vector loads read 4 bytes more than they use.
+    uint16_t nBytes=AIS_BITS_TO_BYTES(Length);
+#endif
+#if defined(__AVX2__)
+    for ( ; i+32<=nFull && iByte+28<=nBytes; i+=32, iByte+=24 ) {
+      __m256i in=_mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(p+iByte))),
+                                         _mm_loadu_si128((const __m128i *)(p+iByte+12)), 1);
+      _mm256_storeu_si256((__m256i *)(Dst+i), AISArmor6x2(AISUnpack6x2(in)));
+    }
+#endif
+#if defined(__SSSE3__)
+    for ( ; i+16<=nFull && iByte+16<=nBytes; i+=16, iByte+=12 ) {
+      __m128i in=_mm_loadu_si128((const __m128i *)(p+iByte));
+      _mm_storeu_si128((__m128i *)(Dst+i), AISArmor6(AISUnpack6(in)));
+    }
+#endif
+    // Scalar: 3 bytes -> 4 characters
+    for ( ; i+4<=nFull; i+=4, iByte+=3 ) {
+      uint32_t v=((uint32_t)p[iByte]<<16) | ((uint32_t)p[iByte+1]<<8) | p[iByte+2];
+      Dst[i]=AISArmorChars[(v>>18) & 0x3f];
+      Dst[i+1]=AISArmorChars[(v>>12) & 0x3f];
+      Dst[i+2]=AISArmorChars[(v>>6) & 0x3f];
+      Dst[i+3]=AISArmorChars[v & 0x3f];
+    }
+  }
+
+  for ( ; i<nChars; i++ ) {
+    uint16_t Pos=i*6;
+    uint8_t n=( Length-Pos<6 ? Length-Pos : 6 );
+    Dst[i]=AISArmorChars[AISGetBits(Bits, Start+Pos, n)<<(6-n)];
+  }
+  Dst[nChars]=0;
+
+  return nChars;
+}
+
+//*****************************************************************************
+// Up to 5 characters are collected and written with one AISSetBits. The rest of
+// the field stays 0 = "@", as the buffer is cleared.
+void AISSetText(uint8_t *Bits, uint16_t Pos, uint8_t nChars, const char *Text) {
+  const uint8_t *p=(const uint8_t *)Text;
+  while ( nChars>0 ) {
+    uint8_t n=( nChars<5 ? nChars : 5 );
+    uint8_t i;
+    uint32_t v=0;
+    for (i=0; i<n && p[i]!=0; i++) v=(v<<6) | AISTextCodes[p[i]];
+    if ( i>0 ) AISSetBits(Bits, Pos, 6*i, v);
+    if ( i<n ) return;
+    p+=n; Pos+=6*n; nChars-=n;
+  }
+}
+
+//*****************************************************************************
+void AISGetText(const uint8_t *Bits, uint16_t Pos, uint8_t nChars, char *Text) {
+  uint8_t Len=0;
+  for (uint8_t i=0; i<nChars; i++, Pos+=6) {
+    Text[i]=AISTextChars[AISGetBits(Bits, Pos, 6)];
+    if ( Text[i]!='@' && Text[i]!=' ' ) Len=i+1;
+  }
+  Text[Len]=0;
+}
+
+//*****************************************************************************
+bool AISDearmorPayload(uint8_t *Bits, uint16_t MaxBits, uint16_t &Length,
+                       const char *Payload, uint16_t nChars, uint8_t FillBits) {
+  if ( nChars==0 || FillBits>5 ) return false;
+  if ( (uint32_t)Length+nChars*6-FillBits>MaxBits ) return false;
+
+  const uint8_t *p=(const uint8_t *)Payload;
+  const uint8_t *End=p+nChars-1;  // last character is handled separately for fill bits
+  uint16_t Pos=Length;
+
+  // Byte aligned: 4 characters -> 3 complete bytes, stored directly
+  if ( (Pos & 7)==0 ) {
+    uint8_t *Dst=Bits+(Pos>>3);
+    for ( ; End-p>=4; p+=4, Dst+=3, Pos+=24) {
+      uint8_t v0=AISDearmorValues[p[0]], v1=AISDearmorValues[p[1]], v2=AISDearmorValues[p[2]], v3=AISDearmorValues[p[3]];
+      if ( (v0|v1|v2|v3)&0xc0 ) return false;
+      uint32_t v=((uint32_t)v0<<18) | ((uint32_t)v1<<12) | ((uint32_t)v2<<6) | v3;
+      Dst[0]=(uint8_t)(v>>16); Dst[1]=(uint8_t)(v>>8); Dst[2]=(uint8_t)v;
+    }
+  }
+
+  for ( ; p<End; p++, Pos+=6) {
+    uint8_t v=AISDearmorValues[*p];
+    if ( v&0xc0 ) return false;
+    AISSetBits(Bits, Pos, 6, v);
+  }
+
+  uint8_t v=AISDearmorValues[*p];
+  if ( v&0xc0 ) return false;
+  if ( FillBits<6 ) AISSetBits(Bits, Pos, 6-FillBits, v>>FillBits);
+  Length=Pos+6-FillBits;
+
+  return true;
+}
@@ -0,0 +1,107 @@
+/*
+NMEA0183AISBits.h
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+// Packed AIS bit buffer and 6-bit armoring.
+// Bits are stored MSB first, bit 0 of the AIS payload is bit 7 of byte 0, exactly
+// in the order they appear in the 6-bit armored payload.
+// Writers OR the value into the buffer, so the buffer has to be cleared before use.
+
+#ifndef _tNMEA0183AISBits_H_
+#define _tNMEA0183AISBits_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Number of bytes needed to hold Bits packed bits
+#define AIS_BITS_TO_BYTES(Bits) (((Bits)+7)/8)
+
+//*****************************************************************************
+// Write the lowest Len bits (Len 1...32) of Value to Buf starting at bit Pos
+inline void AISSetBits(uint8_t *Buf, uint16_t Pos, uint8_t Len, uint32_t Value) {
+  uint8_t *p=Buf+(Pos>>3);
+  uint8_t Used=Pos & 7;
+  if ( Len<32 ) Value&=((uint32_t)1<<Len)-1;
+  // Left align value in a 64 bit window starting at byte p. Used+Len <= 39, so it always fits.
+  uint64_t w=((uint64_t)Value)<<(64-Len-Used);
+  uint8_t nBytes=(Used+Len+7)>>3;
+  for (uint8_t i=0; i<nBytes; i++) {
+    p[i]|=(uint8_t)(w>>(56-8*i));
+  }
+}
+
+//*****************************************************************************
+// Read Len bits (Len 1...32) from Buf starting at bit Pos, returned right aligned
+inline uint32_t AISGetBits(const uint8_t *Buf, uint16_t Pos, uint8_t Len) {
+  const uint8_t *p=Buf+(Pos>>3);
+  uint8_t Used=Pos & 7;
+  uint8_t nBytes=(Used+Len+7)>>3;
+  uint64_t w=0;
+  for (uint8_t i=0; i<nBytes; i++) {
+    w|=((uint64_t)p[i])<<(56-8*i);
+  }
+  return (uint32_t)((w<<Used)>>(64-Len));
+}
+
+//*****************************************************************************
+// Copy Len bits from Src starting at SrcPos to Dst starting at DstPos.
+// Destination range has to be cleared.
+inline void AISCopyBits(uint8_t *Dst, uint16_t DstPos, const uint8_t *Src, uint16_t SrcPos, uint16_t Len) {
+  while ( Len>0 ) {
+    uint8_t n=(Len>32?32:Len);
+    AISSetBits(Dst, DstPos, n, AISGetBits(Src, SrcPos, n));
+    DstPos+=n; SrcPos+=n; Len-=n;
+  }
+}
+
+//*****************************************************************************
+// 6-bit value -> AIS payload character ("0"..."W", "`"..."w")
+extern const char AISArmorChars[64];
+
+//*****************************************************************************
+// Armor Length bits of Bits starting at bit Start into Dst and terminate it.
+// Dst must have room for (Length+5)/6+1 characters. Last character is filled up
+// with 0 bits, if Length is not a multiple of 6.
+// Returns number of characters written without terminating 0.
+uint16_t AISArmorBits(char *Dst, const uint8_t *Bits, uint16_t Start, uint16_t Length);
+
+//*****************************************************************************
+// Write Text as nChars 6-bit characters starting at bit Pos. Text shorter than
+// nChars is filled up with "@" (0), longer one is cut. Lowercase letters are written
+// as uppercase, other characters not in the AIS table as "@". Text is not changed.
+void AISSetText(uint8_t *Bits, uint16_t Pos, uint8_t nChars, const char *Text);
+
+//*****************************************************************************
+// Read nChars 6-bit characters starting at bit Pos as text. Trailing "@" and
+// spaces are removed. Text must have room for nChars+1 characters.
+void AISGetText(const uint8_t *Bits, uint16_t Pos, uint8_t nChars, char *Text);
+
+//*****************************************************************************
+// Reverse of AISArmorBits. Append nChars payload characters to Bits at bit Length
+// and drop FillBits from the end. Length is updated to the new bit count.
+// Bits from Length on have to be cleared.
+// Returns false on invalid payload character or if MaxBits would be exceeded.
+bool AISDearmorPayload(uint8_t *Bits, uint16_t MaxBits, uint16_t &Length,
+                       const char *Payload, uint16_t nChars, uint8_t FillBits);
+
+#endif
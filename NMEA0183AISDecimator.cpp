@@ -0,0 +1,122 @@
+/*
+NMEA0183AISDecimator.cpp
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "NMEA0183AISDecimator.h"
+#include "NMEA0183AISLayout.h"
+
+//*****************************************************************************
+tAISReportDecimator::tAISReportDecimator() : COGChange(100), SOGChange(20) {
+  for (uint8_t i=0; i<AIS_DECIMATOR_SINKS; i++) Periods[i]=0;
+  Clear();
+}
+
+//*****************************************************************************
+void tAISReportDecimator::Clear() {
+  Map.Clear();
+  PassedCount=0;
+  BypassedCount=0;
+  DroppedCount=0;
+}
+
+//*****************************************************************************
+void tAISReportDecimator::ResetSink(uint8_t Sink) {
+  if ( Sink>=AIS_DECIMATOR_SINKS ) return;
+  uint32_t Mask=~((uint32_t)1<<Sink);
+  for (uint16_t Slot=0; Slot<AIS_DECIMATOR_SIZE; Slot++) {
+    if ( Map.IsUsed(Slot) ) Map.GetValue(Slot).Passed&=Mask;
+  }
+}
+
+//*****************************************************************************
+// Change to or from "not available" is always significant
+bool tAISReportDecimator::Significant(const tAISDecimatorReport &Last, uint8_t NavStatus, uint16_t SOG, uint16_t COG) const {
+  if ( NavStatus!=Last.NavStatus ) return true;
+
+  if ( COGChange!=0 && COG!=Last.COG ) {
+    if ( COG>=3600 || Last.COG>=3600 ) return true;
+    uint16_t d=( COG>Last.COG ? COG-Last.COG : Last.COG-COG );
+    if ( d>1800 ) d=3600-d;
+    if ( d>=COGChange ) return true;
+  }
+
+  if ( SOGChange!=0 && SOG!=Last.SOG ) {
+    if ( SOG>=1023 || Last.SOG>=1023 ) return true;
+    uint16_t d=( SOG>Last.SOG ? SOG-Last.SOG : Last.SOG-SOG );
+    if ( d>=SOGChange ) return true;
+  }
+
+  return false;
+}
+
+//*****************************************************************************
+uint32_t tAISReportDecimator::Pass(uint32_t Now, uint32_t Sinks, uint32_t UserID, uint8_t NavStatus, uint16_t SOG, uint16_t COG) {
+  tAISDecimatorTarget *Target=Map.Insert(UserID);
+  if ( Target==0 ) return Sinks;
+
+  uint32_t Result=( AIS_DECIMATOR_SINKS<32 ? Sinks & ( ~(uint32_t)0<<(AIS_DECIMATOR_SINKS & 31) ) : 0 );
+
+  for (uint8_t Sink=0; Sink<AIS_DECIMATOR_SINKS; Sink++) {
+    uint32_t Bit=(uint32_t)1<<Sink;
+    if ( (Sinks & Bit)==0 ) continue;
+
+    tAISDecimatorReport &Last=Target->Reports[Sink];
+    if ( (Target->Passed & Bit)==0 || Now-Last.Time>=Periods[Sink] ) {
+      PassedCount++;
+    } else if ( Significant(Last, NavStatus, SOG, COG) ) {
+      BypassedCount++;
+    } else {
+      DroppedCount++;
+      continue;
+    }
+
+    Last.Time=Now;
+    Last.COG=COG;
+    Last.SOG=SOG;
+    Last.NavStatus=NavStatus;
+    Target->Passed|=Bit;
+    Result|=Bit;
+  }
+
+  return Result;
+}
+
+//*****************************************************************************
+uint32_t tAISReportDecimator::Pass(uint32_t Now, uint32_t Sinks, const uint8_t *Bits, uint16_t Length) {
+  typedef tAISMessage1Layout L1;
+  typedef tAISMessage18Layout L18;
+
+  if ( Length<L1::Length ) return Sinks;
+
+  switch ( L1::Get<L1::MessageType>(Bits) ) {
+    case 1:
+    case 2:
+    case 3:
+      return Pass(Now, Sinks, L1::Get<L1::UserID>(Bits), L1::Get<L1::NavStatus>(Bits),
+                  L1::Get<L1::SOG>(Bits), L1::Get<L1::COG>(Bits));
+    case 18:
+      return Pass(Now, Sinks, L18::Get<L18::UserID>(Bits), 15, L18::Get<L18::SOG>(Bits), L18::Get<L18::COG>(Bits));
+  }
+
+  return Sinks;
+}
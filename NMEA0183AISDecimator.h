@@ -0,0 +1,106 @@
+/*
+NMEA0183AISDecimator.h
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+// Reporting rate decimation of position reports (Message 1, 2, 3 and 18) for slow
+// output links. Each output (serial port, network client, ...) is a sink with its own
+// minimum period between reports of the same MMSI. A report is passed before the
+// period has elapsed, if navigational status, COG or SOG changed significantly
+// against the report last passed to that sink.
+
+#ifndef _tNMEA0183AISDecimator_H_
+#define _tNMEA0183AISDecimator_H_
+
+#include <stdint.h>
+#include "NMEA0183AISRegistry.h"
+
+#ifndef AIS_DECIMATOR_SIZE
+#define AIS_DECIMATOR_SIZE AIS_TABLE_SIZE(8,32,128)  // targets tracked, least recently reported one is replaced
+#endif
+
+#ifndef AIS_DECIMATOR_SINKS
+#define AIS_DECIMATOR_SINKS AIS_TABLE_SIZE(2,4,12)  // outputs with own period, max 32. 8 bytes per sink and target
+#endif
+
+static_assert(AIS_DECIMATOR_SINKS>0 && AIS_DECIMATOR_SINKS<=32, "AIS_DECIMATOR_SINKS must be 1...32");
+
+//*****************************************************************************
+// Report last passed to a sink, values in AIS units
+struct tAISDecimatorReport {
+  uint32_t Time;            // [ms]
+  uint16_t COG : 12;        // [0.1 deg], 3600 = not available
+  uint16_t NavStatus : 4;   // 15 = not defined, always for Class B
+  uint16_t SOG;             // [0.1 kn], 1023 = not available
+};
+
+struct tAISDecimatorTarget {
+  uint32_t Passed;          // bit per sink, a report has been passed to it
+  tAISDecimatorReport Reports[AIS_DECIMATOR_SINKS];
+
+  tAISDecimatorTarget() : Passed(0) {}
+};
+
+//*****************************************************************************
+class tAISReportDecimator {
+  public:
+    typedef tAISMMSIMap<tAISDecimatorTarget, AIS_DECIMATOR_SIZE> tMap;
+    static const uint32_t AllSinks=0xffffffff;
+
+  protected:
+    tMap Map;
+    uint32_t Periods[AIS_DECIMATOR_SINKS];
+    uint16_t COGChange;
+    uint16_t SOGChange;
+    uint32_t PassedCount;
+    uint32_t BypassedCount;
+    uint32_t DroppedCount;
+
+    bool Significant(const tAISDecimatorReport &Last, uint8_t NavStatus, uint16_t SOG, uint16_t COG) const;
+
+  public:
+    tAISReportDecimator();
+    void Clear();
+
+    // Minimum time [ms] between reports of a target to Sink, 0 (default) passes all reports
+    void SetPeriod(uint8_t Sink, uint32_t Period) { if ( Sink<AIS_DECIMATOR_SINKS ) Periods[Sink]=Period; }
+    uint32_t GetPeriod(uint8_t Sink) const { return ( Sink<AIS_DECIMATOR_SINKS ? Periods[Sink] : 0 ); }
+    // Changes against the last passed report, which pass at once. COG [0.1 deg], default 100,
+    // SOG [0.1 kn], default 20. 0 disables the check. Any change of NavStatus always passes.
+    void SetThresholds(uint16_t _COGChange, uint16_t _SOGChange) { COGChange=_COGChange; SOGChange=_SOGChange; }
+    // Forget reports passed to Sink, e.g. when a new client takes it over. Its next reports pass.
+    void ResetSink(uint8_t Sink);
+
+    // Report of UserID at Now [ms], e.g. millis(). Returns the bits of Sinks, to which it should be sent;
+    // they are marked as passed. Bits above AIS_DECIMATOR_SINKS are returned unchanged.
+    uint32_t Pass(uint32_t Now, uint32_t Sinks, uint32_t UserID, uint8_t NavStatus, uint16_t SOG, uint16_t COG);
+    // Same for payload Bits with Length bits. Other messages than position reports pass to all Sinks.
+    uint32_t Pass(uint32_t Now, uint32_t Sinks, const uint8_t *Bits, uint16_t Length);
+
+    // Counters per sink and report: passed after the period, passed by significant change, dropped
+    uint32_t GetPassedCount() const { return PassedCount; }
+    uint32_t GetBypassedCount() const { return BypassedCount; }
+    uint32_t GetDroppedCount() const { return DroppedCount; }
+    uint16_t Size() const { return Map.Size(); }
+};
+
+#endif
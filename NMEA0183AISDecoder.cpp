@@ -0,0 +1,433 @@
+/*
+NMEA0183AISDecoder.cpp
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Based on the works of Eric S. Raymond and Kurt Schwehr https://gpsd.gitlab.io/gpsd/AIVDM.html
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "NMEA0183AISDecoder.h"
+#include "NMEA0183AISLayout.h"
+#include <string.h>
+
+const double pi=3.1415926535897932384626433832795;
+const double knToms=1852.0/3600.0;
+const double degToRad=pi/180.0;
+const double radsToDegMin = 60 * 360.0 / (2 * pi);    // [rad/s -> degree/minute]
+
+// Minimum payload bits accepted. Some transmitters send Type 5 with 420 and Type 24 Part A with 160 bits.
+#define AIS_MSG1_MIN_BITS 168
+#define AIS_MSG5_MIN_BITS 420
+#define AIS_MSG18_MIN_BITS 168
+#define AIS_MSG24A_MIN_BITS 160
+#define AIS_MSG24B_MIN_BITS 168
+
+template <class L> static void GetPosition(const uint8_t *Bits, double &Latitude, double &Longitude, bool &Accuracy, bool &RAIM,
+                                           uint8_t &Seconds, double &COG, double &SOG, double &Heading);
+template <class L> static void GetDimensions(const uint8_t *Bits, double &Length, double &Beam, double &PosRefStbd, double &PosRefBow);
+static tN2kGNSStype N2kGNSStype(uint8_t EPFDFixType);
+
+//****************************  SENTENCES  *************************************
+static inline int8_t HexValue(char c) {
+  if ( c>='0' && c<='9' ) return c-'0';
+  if ( c>='A' && c<='F' ) return c-'A'+10;
+  if ( c>='a' && c<='f' ) return c-'a'+10;
+  return -1;
+}
+
+static inline bool IsDigit(char c) { return c>='0' && c<='9'; }
+
+//******************************************************************************
+// !AIVDM,1,1,,A,133m@ogP00PD;88MD5MTDww@2D7k,0*46
+bool AISParseSentence(const char *Sentence, size_t Len, tAISSentence &AISSentence) {
+  while ( Len>0 && (Sentence[Len-1]=='\r' || Sentence[Len-1]=='\n') ) Len--;
+  // shortest possible: !xxVDM,1,1,,,0,0*hh
+  if ( Len<19 || Sentence[0]!='!' || Sentence[Len-3]!='*' ) return false;
+
+  const char *Star=Sentence+Len-3;
+  int8_t hi=HexValue(Star[1]);
+  int8_t lo=HexValue(Star[2]);
+  if ( hi<0 || lo<0 ) return false;
+  uint8_t CheckSum=0;
+  for (const char *c=Sentence+1; c<Star; c++) CheckSum^=*c;
+  if ( CheckSum!=((hi<<4) | lo) ) return false;
+
+  const char *p=Sentence+3;  // skip talker ID
+  if ( p[0]!='V' || p[1]!='D' || (p[2]!='M' && p[2]!='O') || p[3]!=',' ) return false;
+  AISSentence.Own=(p[2]=='O');
+  p+=4;
+
+  if ( !IsDigit(p[0]) || p[1]!=',' || !IsDigit(p[2]) || p[3]!=',' ) return false;
+  AISSentence.FragmentCount=p[0]-'0';
+  AISSentence.FragmentNumber=p[2]-'0';
+  if ( AISSentence.FragmentCount==0 || AISSentence.FragmentNumber==0 ||
+       AISSentence.FragmentNumber>AISSentence.FragmentCount ) return false;
+  p+=4;
+
+  if ( *p==',' ) {
+    AISSentence.SequentialID=-1;
+  } else {
+    if ( !IsDigit(p[0]) || p[1]!=',' ) return false;
+    AISSentence.SequentialID=p[0]-'0';
+    p++;
+  }
+  p++;
+
+  if ( *p==',' ) {
+    AISSentence.Channel=0;
+  } else {
+    if ( p[1]!=',' ) return false;
+    AISSentence.Channel=p[0];
+    p++;
+  }
+  p++;
+
+  if ( p>=Star ) return false;
+  const char *Comma=(const char *)memchr(p, ',', Star-p);
+  if ( Comma==0 || Comma==p ) return false;
+  AISSentence.Payload=p;
+  AISSentence.PayloadLen=Comma-p;
+  p=Comma+1;
+
+  if ( p+1!=Star || *p<'0' || *p>'5' ) return false;
+  AISSentence.FillBits=*p-'0';
+
+  return true;
+}
+
+//******************************************************************************
+bool AISNextSentence(const char *&Pos, const char *End, tAISSentence &AISSentence, uint32_t *Errors) {
+  while ( Pos<End ) {
+    const char *Start=(const char *)memchr(Pos, '!', End-Pos);
+    if ( Start==0 ) break;
+    const char *Eol=(const char *)memchr(Start, '\n', End-Start);
+    const char *LineEnd=( Eol ? Eol : End );
+    Pos=( Eol ? Eol+1 : End );
+    if ( AISParseSentence(Start, LineEnd-Start, AISSentence) ) return true;
+    if ( Errors ) (*Errors)++;
+  }
+  Pos=End;
+
+  return false;
+}
+
+//******************************************************************************
+bool AISDecodePayload(const tAISSentence &AISSentence, uint8_t *Bits, uint16_t MaxBits, uint16_t &Length) {
+  if ( AISSentence.FragmentCount!=1 ) return false;
+  memset(Bits, 0, AIS_BITS_TO_BYTES(MaxBits));
+  Length=0;
+
+  return AISDearmorPayload(Bits, MaxBits, Length, AISSentence.Payload, AISSentence.PayloadLen, AISSentence.FillBits);
+}
+
+//****************************  MESSAGES  **************************************
+uint8_t AISGetMessageType(const uint8_t *Bits, uint16_t Length) {
+  if ( Length<38 ) return 0;
+  return AISGetBits(Bits, 0, 6);
+}
+
+//******************************************************************************
+bool AISDecodeClassAPositionReport(const uint8_t *Bits, uint16_t Length, tAISClassAPositionReport &Data) {
+  typedef tAISMessage1Layout L;
+  if ( Length<AIS_MSG1_MIN_BITS ) return false;
+  Data.MessageType=L::Get<L::MessageType>(Bits);
+  if ( Data.MessageType<1 || Data.MessageType>3 ) return false;
+
+  Data.Repeat=L::Get<L::Repeat>(Bits);
+  Data.UserID=L::Get<L::UserID>(Bits);
+  Data.NavStatus=L::Get<L::NavStatus>(Bits);
+  int32_t ROT=L::Get<L::ROT>(Bits);
+  Data.ROT=( ROT==L::ROT::NA ? N2kDoubleNA : ROT/radsToDegMin );
+  GetPosition<L>(Bits, Data.Latitude, Data.Longitude, Data.Accuracy, Data.RAIM, Data.Seconds, Data.COG, Data.SOG, Data.Heading);
+
+  return true;
+}
+
+//******************************************************************************
+bool AISDecodeClassAStaticData(const uint8_t *Bits, uint16_t Length, tAISClassAStaticData &Data) {
+  typedef tAISMessage5Layout L;
+  if ( Length<AIS_MSG5_MIN_BITS || L::Get<L::MessageType>(Bits)!=5 ) return false;
+
+  Data.Repeat=L::Get<L::Repeat>(Bits);
+  Data.UserID=L::Get<L::UserID>(Bits);
+  Data.IMONumber=L::Get<L::IMONumber>(Bits);
+  AISGetText(Bits, L::Callsign::Offset, L::Callsign::Chars, Data.Callsign);
+  AISGetText(Bits, L::Name::Offset, L::Name::Chars, Data.Name);
+  Data.VesselType=L::Get<L::VesselType>(Bits);
+  GetDimensions<L>(Bits, Data.Length, Data.Beam, Data.PosRefStbd, Data.PosRefBow);
+  Data.EPFDFixType=L::Get<L::EPFDFixType>(Bits);
+  Data.GNSStype=N2kGNSStype(Data.EPFDFixType);
+  Data.ETAMonth=L::Get<L::ETAMonth>(Bits);
+  Data.ETADay=L::Get<L::ETADay>(Bits);
+  uint8_t Hour=L::Get<L::ETAHour>(Bits);
+  uint8_t Minute=L::Get<L::ETAMinute>(Bits);
+  Data.ETAtime=( Hour<24 && Minute<60 ? Hour*3600.0+Minute*60.0 : N2kDoubleNA );
+  uint8_t Draught=L::Get<L::Draught>(Bits);
+  Data.Draught=( Draught==L::Draught::NA ? N2kDoubleNA : Draught/10.0 );
+  AISGetText(Bits, L::Destination::Offset, L::Destination::Chars, Data.Destination);
+  // DTE is bit 422, not sent with 420 bits
+  Data.DTE=( Length>L::DTE::Offset ? L::Get<L::DTE>(Bits) : (uint8_t)L::DTE::NA );
+
+  return true;
+}
+
+//******************************************************************************
+bool AISDecodeClassBPositionReport(const uint8_t *Bits, uint16_t Length, tAISClassBPositionReport &Data) {
+  typedef tAISMessage18Layout L;
+  if ( Length<AIS_MSG18_MIN_BITS || L::Get<L::MessageType>(Bits)!=18 ) return false;
+
+  Data.Repeat=L::Get<L::Repeat>(Bits);
+  Data.UserID=L::Get<L::UserID>(Bits);
+  GetPosition<L>(Bits, Data.Latitude, Data.Longitude, Data.Accuracy, Data.RAIM, Data.Seconds, Data.COG, Data.SOG, Data.Heading);
+  Data.Unit=(tN2kAISUnit)L::Get<L::Unit>(Bits);
+  Data.Display=L::Get<L::Display>(Bits);
+  Data.DSC=L::Get<L::DSC>(Bits);
+  Data.Band=L::Get<L::Band>(Bits);
+  Data.Msg22=L::Get<L::Msg22>(Bits);
+  Data.Mode=L::Get<L::Mode>(Bits);
+
+  return true;
+}
+
+//******************************************************************************
+bool AISDecodeClassBStaticData(const uint8_t *Bits, uint16_t Length, tAISClassBStaticData &Data) {
+  typedef tAISMessage24ALayout LA;
+  typedef tAISMessage24BLayout LB;
+  if ( Length<AIS_MSG24A_MIN_BITS || LA::Get<LA::MessageType>(Bits)!=24 ) return false;
+
+  Data.Repeat=LA::Get<LA::Repeat>(Bits);
+  Data.UserID=LA::Get<LA::UserID>(Bits);
+  Data.PartNumber=LA::Get<LA::PartNumber>(Bits);
+  Data.Name[0]=0;
+  Data.VesselType=0;
+  Data.VendorID[0]=0;
+  Data.Callsign[0]=0;
+  Data.Length=Data.Beam=Data.PosRefStbd=Data.PosRefBow=N2kDoubleNA;
+  Data.MothershipID=0;
+
+  if ( Data.PartNumber==0 ) {
+    AISGetText(Bits, LA::Name::Offset, LA::Name::Chars, Data.Name);
+    return true;
+  }
+  if ( Data.PartNumber!=1 || Length<AIS_MSG24B_MIN_BITS ) return false;
+
+  Data.VesselType=LB::Get<LB::VesselType>(Bits);
+  AISGetText(Bits, LB::VendorID::Offset, LB::VendorID::Chars, Data.VendorID);
+  AISGetText(Bits, LB::Callsign::Offset, LB::Callsign::Chars, Data.Callsign);
+  if ( Data.UserID/10000000==98 ) {  // auxiliary craft 98XXXYYYY
+    Data.MothershipID=LB::Get<LB::MothershipID>(Bits);
+  } else {
+    GetDimensions<LB>(Bits, Data.Length, Data.Beam, Data.PosRefStbd, Data.PosRefBow);
+  }
+
+  return true;
+}
+
+//******************************************************************************
+bool AISDecodeMessage(const uint8_t *Bits, uint16_t Length, tAISDecodedMessage &Msg) {
+  Msg.MessageType=AISGetMessageType(Bits, Length);
+  switch ( Msg.MessageType ) {
+    case 1:
+    case 2:
+    case 3:  return AISDecodeClassAPositionReport(Bits, Length, Msg.ClassAPosition);
+    case 5:  return AISDecodeClassAStaticData(Bits, Length, Msg.ClassAStatic);
+    case 18: return AISDecodeClassBPositionReport(Bits, Length, Msg.ClassBPosition);
+    case 24: return AISDecodeClassBStaticData(Bits, Length, Msg.ClassBStatic);
+  }
+
+  return false;
+}
+
+//*************************  FRAGMENT REASSEMBLY  ******************************
+tAISFragmentReassembler::tAISFragmentReassembler(uint32_t _Timeout) : Timeout(_Timeout) {
+  Clear();
+  ResetCounters();
+}
+
+//******************************************************************************
+void tAISFragmentReassembler::Clear() {
+  for (uint8_t i=0; i<AIS_REASSEMBLY_SLOTS; i++) Slots[i].NextFragment=0;
+  Single.NextFragment=0;
+}
+
+//******************************************************************************
+// Free slot and count the fragments it holds
+void tAISFragmentReassembler::Drop(tSlot &Slot, uint32_t &Counter) {
+  if ( Slot.NextFragment==0 ) return;
+  Counter+=Slot.NextFragment-1;
+  Slot.NextFragment=0;
+}
+
+//******************************************************************************
+void tAISFragmentReassembler::Expire(uint32_t Now) {
+  for (uint8_t i=0; i<AIS_REASSEMBLY_SLOTS; i++) {
+    if ( Slots[i].NextFragment!=0 && (uint32_t)(Now-Slots[i].Time)>Timeout ) Drop(Slots[i], Expired);
+  }
+}
+
+//******************************************************************************
+// Slot in progress for sentence key, expires stale slots on the way
+tAISFragmentReassembler::tSlot *tAISFragmentReassembler::Find(const tAISSentence &AISSentence, uint32_t Now) {
+  tSlot *Found=0;
+  for (uint8_t i=0; i<AIS_REASSEMBLY_SLOTS; i++) {
+    tSlot &Slot=Slots[i];
+    if ( Slot.NextFragment==0 ) continue;
+    if ( (uint32_t)(Now-Slot.Time)>Timeout ) {
+      Drop(Slot, Expired);
+    } else if ( Slot.Channel==AISSentence.Channel && Slot.SequentialID==AISSentence.SequentialID &&
+                Slot.FragmentCount==AISSentence.FragmentCount ) {
+      Found=&Slot;
+    }
+  }
+  return Found;
+}
+
+//******************************************************************************
+bool tAISFragmentReassembler::Add(const tAISSentence &AISSentence, uint32_t Now, const uint8_t *&Bits, uint16_t &Length) {
+  tSlot *Slot;
+
+  if ( AISSentence.FragmentCount==1 ) {
+    Slot=&Single;
+  } else {
+    Slot=Find(AISSentence, Now);
+    if ( AISSentence.FragmentNumber==1 ) {
+      if ( Slot!=0 ) {  // previous message with same key never completed
+        Drop(*Slot, Orphaned);
+      } else {
+        tSlot *Oldest=0;
+        for (uint8_t i=0; i<AIS_REASSEMBLY_SLOTS && Slot==0; i++) {
+          if ( Slots[i].NextFragment==0 ) {
+            Slot=&Slots[i];
+          } else if ( Oldest==0 || (int32_t)(Slots[i].Time-Oldest->Time)<0 ) {
+            Oldest=&Slots[i];
+          }
+        }
+        if ( Slot==0 ) {
+          Slot=Oldest;
+          Drop(*Slot, Evicted);
+        }
+      }
+    } else {
+      if ( Slot==0 ) {
+        Orphaned++;
+        return false;
+      }
+      if ( Slot->NextFragment!=AISSentence.FragmentNumber ) {  // gap, message can not be completed
+        Drop(*Slot, Orphaned);
+        Orphaned++;
+        return false;
+      }
+    }
+  }
+
+  if ( AISSentence.FragmentNumber==1 ) {
+    memset(Slot->Bits, 0, sizeof(Slot->Bits));
+    Slot->Length=0;
+    Slot->Time=Now;
+    Slot->FragmentCount=AISSentence.FragmentCount;
+    Slot->SequentialID=AISSentence.SequentialID;
+    Slot->Channel=AISSentence.Channel;
+  }
+  Slot->NextFragment=AISSentence.FragmentNumber+1;
+
+  if ( !AISDearmorPayload(Slot->Bits, AIS_DECODE_MAX_BITS, Slot->Length,
+                          AISSentence.Payload, AISSentence.PayloadLen, AISSentence.FillBits) ) {
+    Drop(*Slot, Invalid);
+    return false;
+  }
+
+  if ( AISSentence.FragmentNumber<AISSentence.FragmentCount ) return false;
+
+  Slot->NextFragment=0;
+  Bits=Slot->Bits;
+  Length=Slot->Length;
+
+  return true;
+}
+
+//******************************************************************************
+bool tAISFragmentReassembler::Add(const tAISSentence &AISSentence, uint32_t Now, tAISDecodedMessage &Msg) {
+  const uint8_t *Bits;
+  uint16_t Length;
+
+  return Add(AISSentence, Now, Bits, Length) && AISDecodeMessage(Bits, Length, Msg);
+}
+
+//******************************************************************************
+//                 Validations and Unit Transformations
+//******************************************************************************
+
+// *****************************************************************************
+// Position related fields of Message 1, 2, 3 and 18, reverse of SetPosition
+template <class L> void GetPosition(const uint8_t *Bits, double &Latitude, double &Longitude, bool &Accuracy, bool &RAIM,
+                                    uint8_t &Seconds, double &COG, double &SOG, double &Heading) {
+  int32_t v;
+  v=L::template Get<typename L::SOG>(Bits);
+  SOG=( v==L::SOG::NA ? N2kDoubleNA : v/10.0*knToms );
+  Accuracy=L::template Get<typename L::Accuracy>(Bits);
+  v=L::template Get<typename L::Longitude>(Bits);
+  Longitude=( v<-180*600000 || v>180*600000 ? N2kDoubleNA : v/600000.0 );
+  v=L::template Get<typename L::Latitude>(Bits);
+  Latitude=( v<-90*600000 || v>90*600000 ? N2kDoubleNA : v/600000.0 );
+  v=L::template Get<typename L::COG>(Bits);
+  COG=( v>=L::COG::NA ? N2kDoubleNA : v/10.0*degToRad );
+  v=L::template Get<typename L::Heading>(Bits);
+  Heading=( v>359 ? N2kDoubleNA : v*degToRad );
+  Seconds=L::template Get<typename L::Seconds>(Bits);
+  RAIM=L::template Get<typename L::RAIM>(Bits);
+}
+
+// *****************************************************************************
+// Dimensions A, B, C, D -> Length, Beam and position reference, N/A if 0
+template <class L> void GetDimensions(const uint8_t *Bits, double &Length, double &Beam, double &PosRefStbd, double &PosRefBow) {
+  uint16_t A=L::template Get<typename L::DimensionToBow>(Bits);
+  uint16_t B=L::template Get<typename L::DimensionToStern>(Bits);
+  uint16_t C=L::template Get<typename L::DimensionToPort>(Bits);
+  uint16_t D=L::template Get<typename L::DimensionToStbd>(Bits);
+
+  if ( A+B==0 ) {
+    Length=PosRefBow=N2kDoubleNA;
+  } else {
+    Length=A+B;
+    PosRefBow=A;
+  }
+  if ( C+D==0 ) {
+    Beam=PosRefStbd=N2kDoubleNA;
+  } else {
+    Beam=C+D;
+    PosRefStbd=D;
+  }
+}
+
+//  *****************************************************************************
+//  AIS EPFD Fix Type -> tN2kGNSStype, reverse of AISEPFDFixType.
+//  Types not known in N2k (undefined, Loran-C) are returned as GPS.
+tN2kGNSStype N2kGNSStype(uint8_t EPFDFixType) {
+  switch (EPFDFixType) {
+    case 2: return N2kGNSSt_GLONASS;
+    case 3: return N2kGNSSt_GPSGLONASS;
+    case 5: return N2kGNSSt_Chayka;
+    case 6: return N2kGNSSt_integrated;
+    case 7: return N2kGNSSt_surveyed;
+    case 8: return N2kGNSSt_Galileo;
+  }
+  return N2kGNSSt_GPS;
+}
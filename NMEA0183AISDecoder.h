@@ -0,0 +1,237 @@
+/*
+NMEA0183AISDecoder.h
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Based on the works of Eric S. Raymond and Kurt Schwehr https://gpsd.gitlab.io/gpsd/AIVDM.html
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+// Decoding of !AIVDM / !AIVDO sentences, the reverse path of the SetAIS... functions.
+// Sentences are parsed in place from a contiguous input buffer, the payload is
+// de-armored into a packed bit buffer and fields are read with the layouts of
+// NMEA0183AISLayout.h. Nothing is allocated.
+// Decoded values use the same units as the SetAIS... parameters, "not available"
+// values are returned as N2kDoubleNA.
+
+#ifndef _tNMEA0183AISDecoder_H_
+#define _tNMEA0183AISDecoder_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <N2kTypes.h>
+#include "NMEA0183AISBits.h"
+
+#ifndef AIS_DECODE_MAX_BITS
+#define AIS_DECODE_MAX_BITS 1008  // 168 payload characters, longest defined AIS message
+#endif
+
+#ifndef AIS_REASSEMBLY_SLOTS
+#define AIS_REASSEMBLY_SLOTS 16   // multi sentence messages in progress at the same time
+#endif
+
+#ifndef AIS_REASSEMBLY_TIMEOUT
+#define AIS_REASSEMBLY_TIMEOUT 2000  // [ms] incomplete messages older than this are dropped
+#endif
+
+//*****************************************************************************
+// One parsed sentence. Payload points into the input buffer and is not terminated.
+struct tAISSentence {
+  const char *Payload;
+  uint16_t PayloadLen;      // number of payload characters
+  uint8_t FragmentCount;    // 1...9
+  uint8_t FragmentNumber;   // 1...FragmentCount
+  int8_t SequentialID;      // 0...9, -1 = empty field
+  char Channel;             // 'A', 'B' or 0 for empty field
+  uint8_t FillBits;         // 0...5
+  bool Own;                 // true for VDO (own vessel)
+};
+
+//*****************************************************************************
+// Parse and checksum-verify one sentence of Len characters, starting with '!'.
+// Trailing CR/LF is allowed.
+bool AISParseSentence(const char *Sentence, size_t Len, tAISSentence &AISSentence);
+
+//*****************************************************************************
+// Find next valid VDM/VDO sentence in Pos...End and advance Pos behind it.
+// Invalid lines are skipped and counted to Errors, if given.
+// Returns false, when end of buffer has been reached.
+bool AISNextSentence(const char *&Pos, const char *End, tAISSentence &AISSentence, uint32_t *Errors=0);
+
+//*****************************************************************************
+// De-armor payload of single sentence message to Bits (AIS_BITS_TO_BYTES(MaxBits) bytes).
+// Length returns number of payload bits.
+bool AISDecodePayload(const tAISSentence &AISSentence, uint8_t *Bits, uint16_t MaxBits, uint16_t &Length);
+
+//*****************************************************************************
+// Types 1, 2 and 3: Position Report Class A, see SetAISClassABMessage1
+struct tAISClassAPositionReport {
+  uint8_t MessageType;
+  uint8_t Repeat;
+  uint32_t UserID;
+  double Latitude;          // [deg]
+  double Longitude;         // [deg]
+  bool Accuracy;
+  bool RAIM;
+  uint8_t Seconds;
+  double COG;               // [rad]
+  double SOG;               // [m/s]
+  double Heading;           // [rad]
+  double ROT;               // [rad/s]
+  uint8_t NavStatus;
+};
+
+//*****************************************************************************
+// Type 5: Static and Voyage Related Data, see SetAISClassAMessage5
+// ETA has no year in AIS, so it is returned as month, day and ETAtime.
+struct tAISClassAStaticData {
+  uint8_t Repeat;
+  uint32_t UserID;
+  uint32_t IMONumber;
+  char Callsign[8];
+  char Name[21];
+  uint8_t VesselType;
+  double Length;            // [m]
+  double Beam;              // [m]
+  double PosRefStbd;        // [m]
+  double PosRefBow;         // [m]
+  uint8_t ETAMonth;         // 1...12, 0 = not available
+  uint8_t ETADay;           // 1...31, 0 = not available
+  double ETAtime;           // [s] since midnight
+  double Draught;           // [m]
+  char Destination[21];
+  uint8_t EPFDFixType;      // AIS value
+  tN2kGNSStype GNSStype;
+  uint8_t DTE;
+};
+
+//*****************************************************************************
+// Type 18: Standard Class B CS Position Report, see SetAISClassBMessage18
+struct tAISClassBPositionReport {
+  uint8_t Repeat;
+  uint32_t UserID;
+  double Latitude;          // [deg]
+  double Longitude;         // [deg]
+  bool Accuracy;
+  bool RAIM;
+  uint8_t Seconds;
+  double COG;               // [rad]
+  double SOG;               // [m/s]
+  double Heading;           // [rad]
+  tN2kAISUnit Unit;
+  bool Display;
+  bool DSC;
+  bool Band;
+  bool Msg22;
+  bool Mode;
+};
+
+//*****************************************************************************
+// Type 24: Static Data Report, Part A (PartNumber 0) has Name only,
+// Part B (PartNumber 1) all other fields. See SetAISClassBMessage24PartA and SetAISClassBMessage24
+struct tAISClassBStaticData {
+  uint8_t Repeat;
+  uint32_t UserID;
+  uint8_t PartNumber;
+  char Name[21];
+  uint8_t VesselType;
+  char VendorID[8];
+  char Callsign[8];
+  double Length;            // [m]
+  double Beam;              // [m]
+  double PosRefStbd;        // [m]
+  double PosRefBow;         // [m]
+  uint32_t MothershipID;    // auxiliary craft (MMSI 98xxxxxxx) only, dimensions are not available then
+};
+
+//*****************************************************************************
+// Any of the supported messages
+struct tAISDecodedMessage {
+  uint8_t MessageType;
+  union {
+    tAISClassAPositionReport ClassAPosition;
+    tAISClassAStaticData ClassAStatic;
+    tAISClassBPositionReport ClassBPosition;
+    tAISClassBStaticData ClassBStatic;
+  };
+};
+
+//*****************************************************************************
+// Message type of payload, 0 if Length is too short
+uint8_t AISGetMessageType(const uint8_t *Bits, uint16_t Length);
+
+// Decode packed payload. Return false on wrong message type or too short payload.
+bool AISDecodeClassAPositionReport(const uint8_t *Bits, uint16_t Length, tAISClassAPositionReport &Data);
+bool AISDecodeClassAStaticData(const uint8_t *Bits, uint16_t Length, tAISClassAStaticData &Data);
+bool AISDecodeClassBPositionReport(const uint8_t *Bits, uint16_t Length, tAISClassBPositionReport &Data);
+bool AISDecodeClassBStaticData(const uint8_t *Bits, uint16_t Length, tAISClassBStaticData &Data);
+
+// Decode any supported message type. Returns false for unsupported types.
+bool AISDecodeMessage(const uint8_t *Bits, uint16_t Length, tAISDecodedMessage &Msg);
+
+//*****************************************************************************
+// Fixed size table for joining multi sentence messages. Fragments are keyed by
+// channel, sequential ID and fragment count, so interleaved messages from different
+// IDs and channels are joined independently. Each fragment is de-armored directly
+// behind the previous one in the slot's bit buffer.
+// Fragments must arrive in order, as they do from a receiver.
+class tAISFragmentReassembler {
+  protected:
+    struct tSlot {
+      uint32_t Time;            // of first fragment
+      uint16_t Length;          // bits collected so far
+      uint8_t NextFragment;     // expected fragment number, 0 = slot free
+      uint8_t FragmentCount;
+      int8_t SequentialID;
+      char Channel;
+      uint8_t Bits[AIS_BITS_TO_BYTES(AIS_DECODE_MAX_BITS)];
+    };
+
+    tSlot Slots[AIS_REASSEMBLY_SLOTS];
+    tSlot Single;               // for single sentence messages
+    uint32_t Timeout;
+    uint32_t Orphaned;          // fragments without matching beginning or with gap
+    uint32_t Expired;           // fragments of messages not completed within Timeout
+    uint32_t Evicted;           // fragments dropped, because all slots were in use
+    uint32_t Invalid;           // fragments with invalid payload or too long messages
+
+    void Drop(tSlot &Slot, uint32_t &Counter);
+    tSlot *Find(const tAISSentence &AISSentence, uint32_t Now);
+
+  public:
+    tAISFragmentReassembler(uint32_t _Timeout=AIS_REASSEMBLY_TIMEOUT);
+    void Clear();
+
+    // Add sentence received at Now [ms], e.g. millis(). Returns true, when the message is complete.
+    // Bits and Length are then valid until next call of Add.
+    bool Add(const tAISSentence &AISSentence, uint32_t Now, const uint8_t *&Bits, uint16_t &Length);
+    // As above, but decode complete message. Returns false also for unsupported message types.
+    bool Add(const tAISSentence &AISSentence, uint32_t Now, tAISDecodedMessage &Msg);
+    // Drop incomplete messages older than Timeout. Add does this too for slots it looks at.
+    void Expire(uint32_t Now);
+
+    uint32_t GetOrphaned() const { return Orphaned; }
+    uint32_t GetExpired() const { return Expired; }
+    uint32_t GetEvicted() const { return Evicted; }
+    uint32_t GetInvalid() const { return Invalid; }
+    void ResetCounters() { Orphaned=0; Expired=0; Evicted=0; Invalid=0; }
+};
+
+#endif
@@ -0,0 +1,204 @@
+/*
+NMEA0183AISFixedPoint.h
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+// Integer only arithmetic on IEEE 754 double values for the AIS unit conversions.
+// The double is split into sign, 53 bit mantissa and exponent, multiplications are rounded
+// to nearest even like the FPU does, so results are bit exact to the double calculation.
+// Targets without double precision FPU (ESP32, Cortex-M0/M3/M4F) otherwise call the
+// software floating point library for each multiplication, comparison and floor / ceil.
+
+#ifndef _tNMEA0183AISFixedPoint_H_
+#define _tNMEA0183AISFixedPoint_H_
+
+#include <stdint.h>
+#include <string.h>
+
+// 1 = AISLatitude(), AISCOG() etc. in NMEA0183AISMessages.cpp use tAISDouble instead of double.
+// Off by default. Define it as 1 for targets, where double is done in software (ESP32,
+// ARM without double precision FPU). extras/test/AISFixedPointTest.cpp checks, that both
+// settings give the same sentences.
+#ifndef AIS_FIXED_POINT_CONVERSIONS
+#define AIS_FIXED_POINT_CONVERSIONS 0
+#endif
+
+// *****************************************************************************
+// Round the 128 bit integer Hi:Lo (< 2^116) to a 53 bit double mantissa, round half to even.
+// Shift is set to the number of bits removed.
+inline uint64_t AISRoundToDoubleMantissa(uint64_t Hi, uint64_t Lo, uint8_t &Shift) {
+  uint8_t Len = ( Hi != 0 ? 128 - __builtin_clzll(Hi) : ( Lo != 0 ? 64 - __builtin_clzll(Lo) : 0 ) );
+
+  if ( Len <= 53 ) { Shift = 0; return Lo; }
+  Shift = Len - 53;
+  uint64_t Mantissa = ( Lo >> Shift ) | ( Hi << ( 64 - Shift ) );
+  uint64_t Rest = Lo & ( ( (uint64_t)1 << Shift ) - 1 );
+  uint64_t Half = (uint64_t)1 << ( Shift - 1 );
+  if ( Rest > Half || ( Rest == Half && ( Mantissa & 1 ) ) ) Mantissa++;
+  if ( Mantissa == (uint64_t)1 << 53 ) { Mantissa >>= 1; Shift++; }
+  return Mantissa;
+}
+
+// *****************************************************************************
+// Hi:Lo = a * b, a, b < 2^64
+inline void AISMul64x64(uint64_t a, uint64_t b, uint64_t &Hi, uint64_t &Lo) {
+  uint64_t al = a & 0xffffffff, ah = a >> 32;
+  uint64_t bl = b & 0xffffffff, bh = b >> 32;
+  uint64_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+  uint64_t Mid = ( ll >> 32 ) + ( lh & 0xffffffff ) + ( hl & 0xffffffff );
+  Lo = ( Mid << 32 ) | ( ll & 0xffffffff );
+  Hi = hh + ( lh >> 32 ) + ( hl >> 32 ) + ( Mid >> 32 );
+}
+
+//*****************************************************************************
+// Exact value of a double: -1^Neg * M * 2^E with 2^52 <= M < 2^53, or M = 0 for +-0.
+// Infinity and NaN are stored above the largest finite value, NaN compares false to everything.
+// Results, which would be subnormal or overflow as double, are kept with 53 bit mantissa;
+// Trunc(), Ceil() and Round() of them are anyway 0 or out of the int32_t range.
+class tAISDouble {
+  protected:
+    uint64_t M;
+    int16_t E;
+    bool Neg;
+    bool NaN;
+
+    tAISDouble() : M(0), E(0), Neg(false), NaN(false) {}
+
+    // -1, 0, 1 for this <, ==, > b. NaN not handled.
+    int Compare(const tAISDouble &b) const {
+      bool an = Neg && M != 0, bn = b.Neg && b.M != 0;
+      if ( an != bn ) return ( an ? -1 : 1 );
+      int c;
+      if ( M == 0 || b.M == 0 ) c = ( M != 0 ) - ( b.M != 0 );
+      else if ( E != b.E ) c = ( E < b.E ? -1 : 1 );
+      else c = ( M < b.M ? -1 : ( M > b.M ? 1 : 0 ) );
+      return ( an ? -c : c );
+    }
+
+    // Integer part of Abs * 2^Exp, -1 if it is 2^63 or more
+    static int64_t Shifted(uint64_t Abs, int16_t Exp) {
+      if ( Exp >= 11 ) return -1;
+      if ( Exp >= 0 ) return (int64_t)( Abs << Exp );
+      return ( Exp > -64 ? (int64_t)( Abs >> -Exp ) : 0 );
+    }
+
+    // Out of int32_t range gives INT32_MIN, as the double to int conversion on x86 does
+    static int32_t Signed(int64_t Abs, bool Negative) {
+      if ( Abs < 0 || Abs > INT32_MAX ) return INT32_MIN;
+      return ( Negative ? -(int32_t)Abs : (int32_t)Abs );
+    }
+
+  public:
+    explicit tAISDouble(double v) {
+      uint64_t b;
+      memcpy(&b, &v, sizeof(b));
+      Neg = ( b >> 63 ) != 0;
+      NaN = false;
+      int16_t Exp = ( b >> 52 ) & 0x7ff;
+      M = b & ( ( (uint64_t)1 << 52 ) - 1 );
+      if ( Exp == 0x7ff ) {               // infinity or NaN
+        NaN = ( M != 0 );
+        M = (uint64_t)1 << 52;
+        E = 972;
+      } else if ( Exp == 0 ) {            // zero or subnormal
+        if ( M == 0 ) { E = 0; return; }
+        int16_t s = __builtin_clzll(M) - 11;
+        M <<= s;
+        E = -1074 - s;
+      } else {
+        M |= (uint64_t)1 << 52;
+        E = Exp - 1075;
+      }
+    }
+
+    // Exact value of integer n
+    static tAISDouble FromUInt(uint32_t n) {
+      tAISDouble r;
+      if ( n != 0 ) {
+        int16_t s = __builtin_clzll(n) - 11;
+        r.M = (uint64_t)n << s;
+        r.E = -s;
+      }
+      return r;
+    }
+
+    bool IsNaN() const { return NaN; }
+
+    bool operator==(const tAISDouble &b) const { return !NaN && !b.NaN && Compare(b) == 0; }
+    bool operator<(const tAISDouble &b) const { return !NaN && !b.NaN && Compare(b) < 0; }
+    bool operator<=(const tAISDouble &b) const { return !NaN && !b.NaN && Compare(b) <= 0; }
+    bool operator>(const tAISDouble &b) const { return !NaN && !b.NaN && Compare(b) > 0; }
+    bool operator>=(const tAISDouble &b) const { return !NaN && !b.NaN && Compare(b) >= 0; }
+    bool operator==(double b) const { return *this == tAISDouble(b); }
+    bool operator<(double b) const { return *this < tAISDouble(b); }
+    bool operator<=(double b) const { return *this <= tAISDouble(b); }
+    bool operator>(double b) const { return *this > tAISDouble(b); }
+    bool operator>=(double b) const { return *this >= tAISDouble(b); }
+
+    // Product rounded to nearest even like double multiplication
+    tAISDouble operator*(const tAISDouble &b) const {
+      tAISDouble r;
+      r.Neg = ( Neg != b.Neg );
+      r.NaN = ( NaN || b.NaN );
+      if ( M == 0 || b.M == 0 ) return r;
+      uint64_t Hi, Lo;
+      uint8_t Shift;
+      AISMul64x64(M, b.M, Hi, Lo);
+      r.M = AISRoundToDoubleMantissa(Hi, Lo, Shift);
+      r.E = E + b.E + Shift;
+      return r;
+    }
+    tAISDouble operator*(double b) const { return *this * tAISDouble(b); }
+
+    // (int32_t)v
+    int32_t Trunc() const { return Signed(Shifted(M, E), Neg); }
+
+    // (int32_t)ceil(v)
+    int32_t Ceil() const {
+      int64_t Abs = Shifted(M, E);
+      if ( Abs >= 0 && !Neg && M != 0 && E < 0 ) {
+        if ( E <= -64 || ( M & ( ( (uint64_t)1 << -E ) - 1 ) ) != 0 ) Abs++;
+      }
+      return Signed(Abs, Neg);
+    }
+
+    // aRoundToInt(v): (int32_t)floor(v+0.5) for v >= 0, (int32_t)ceil(v-0.5) for v < 0.
+    // The sum is rounded to double before floor / ceil, as in the double calculation.
+    int32_t Round() const {
+      if ( M == 0 ) return 0;
+      if ( NaN ) return INT32_MIN;
+      int64_t Abs;
+      if ( E >= -1 ) {                    // |v| >= 2^51
+        Abs = -1;
+      } else if ( E < -62 ) {             // |v| < 2^-10
+        Abs = 0;
+      } else {
+        uint8_t Shift;
+        uint64_t Sum = M + ( (uint64_t)1 << ( -1 - E ) );
+        uint64_t m = AISRoundToDoubleMantissa(0, Sum, Shift);
+        Abs = Shifted(m, E + Shift);
+      }
+      return Signed(Abs, Neg);
+    }
+};
+
+#endif
@@ -0,0 +1,171 @@
+/*
+NMEA0183AISLayout.h
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Based on the works of Eric S. Raymond and Kurt Schwehr https://gpsd.gitlab.io/gpsd/AIVDM.html
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+// Compile time field layouts of the supported AIS messages.
+// Each field is a type carrying offset, width, signedness and "not available" value,
+// so Layout::Set<Layout::Field>() folds to constant shifts and masks and the
+// range check against the message length is done by the compiler.
+
+#ifndef _tNMEA0183AISLayout_H_
+#define _tNMEA0183AISLayout_H_
+
+#include <stdint.h>
+#include "NMEA0183AISBits.h"
+
+//*****************************************************************************
+template <uint16_t _Offset, uint8_t _Width, bool _Signed=false, int32_t _NA=0>
+struct tAISField {
+  static constexpr uint16_t Offset=_Offset;
+  static constexpr uint8_t Width=_Width;
+  static constexpr bool Signed=_Signed;
+  static constexpr int32_t NA=_NA;
+};
+
+// Text field of _Width/6 6-bit characters, "@" (0) = not available
+template <uint16_t _Offset, uint8_t _Width>
+struct tAISTextField : public tAISField<_Offset,_Width> {
+  static constexpr uint8_t Chars=_Width/6;
+};
+
+//*****************************************************************************
+template <uint16_t _Length>
+struct tAISLayout {
+  static constexpr uint16_t Length=_Length;  // payload bits
+  static constexpr uint16_t Bytes=AIS_BITS_TO_BYTES(_Length);
+
+  template <class Field> static inline void Set(uint8_t *Bits, int32_t Value) {
+    static_assert(Field::Offset+Field::Width<=_Length, "AIS field outside of message");
+    static_assert(Field::Width<=32, "AIS field too wide");
+    AISSetBits(Bits, Field::Offset, Field::Width, (uint32_t)Value);
+  }
+
+  template <class Field> static inline int32_t Get(const uint8_t *Bits) {
+    static_assert(Field::Offset+Field::Width<=_Length, "AIS field outside of message");
+    uint32_t v=AISGetBits(Bits, Field::Offset, Field::Width);
+    if ( Field::Signed && Field::Width<32 && (v & ((uint32_t)1<<(Field::Width-1))) ) v|=~(uint32_t)0<<Field::Width;
+    return (int32_t)v;
+  }
+
+  template <class Field> static inline void SetText(uint8_t *Bits, const char *Text) {
+    static_assert(Field::Offset+Field::Width<=_Length, "AIS field outside of message");
+    AISSetText(Bits, Field::Offset, Field::Chars, Text);
+  }
+};
+
+//*****************************************************************************
+// Common header of all messages
+template <uint16_t _Length>
+struct tAISMessageLayout : public tAISLayout<_Length> {
+  typedef tAISField<  0, 6>            MessageType;
+  typedef tAISField<  6, 2>            Repeat;
+  typedef tAISField<  8,30>            UserID;
+};
+
+//*****************************************************************************
+// Types 1, 2 and 3: Position Report Class A
+struct tAISMessage1Layout : public tAISMessageLayout<168> {
+  typedef tAISField< 38, 4,false,15>   NavStatus;
+  typedef tAISField< 42, 8,true,-128>  ROT;
+  typedef tAISField< 50,10,false,1023> SOG;
+  typedef tAISField< 60, 1>            Accuracy;
+  typedef tAISField< 61,28,true,181*600000> Longitude;
+  typedef tAISField< 89,27,true,91*600000>  Latitude;
+  typedef tAISField<116,12,false,3600> COG;
+  typedef tAISField<128, 9,false,511>  Heading;
+  typedef tAISField<137, 6,false,60>   Seconds;
+  typedef tAISField<143, 2>            Maneuver;
+  typedef tAISField<145, 3>            Spare;
+  typedef tAISField<148, 1>            RAIM;
+  typedef tAISField<149,19>            RadioStatus;
+};
+
+//*****************************************************************************
+// Type 5: Static and Voyage Related Data
+struct tAISMessage5Layout : public tAISMessageLayout<424> {
+  typedef tAISField< 38, 2>            AISVersion;
+  typedef tAISField< 40,30>            IMONumber;
+  typedef tAISTextField< 70,42>        Callsign;
+  typedef tAISTextField<112,120>       Name;
+  typedef tAISField<232, 8>            VesselType;
+  typedef tAISField<240, 9>            DimensionToBow;
+  typedef tAISField<249, 9>            DimensionToStern;
+  typedef tAISField<258, 6>            DimensionToPort;
+  typedef tAISField<264, 6>            DimensionToStbd;
+  typedef tAISField<270, 4>            EPFDFixType;
+  typedef tAISField<274, 4,false,0>    ETAMonth;
+  typedef tAISField<278, 5,false,0>    ETADay;
+  typedef tAISField<283, 5,false,24>   ETAHour;
+  typedef tAISField<288, 6,false,60>   ETAMinute;
+  typedef tAISField<294, 8,false,0>    Draught;
+  typedef tAISTextField<302,120>       Destination;
+  typedef tAISField<422, 1,false,1>    DTE;
+  typedef tAISField<423, 1>            Spare;
+};
+
+//*****************************************************************************
+// Type 18: Standard Class B CS Position Report
+struct tAISMessage18Layout : public tAISMessageLayout<168> {
+  typedef tAISField< 38, 8>            Reserved;
+  typedef tAISField< 46,10,false,1023> SOG;
+  typedef tAISField< 56, 1>            Accuracy;
+  typedef tAISField< 57,28,true,181*600000> Longitude;
+  typedef tAISField< 85,27,true,91*600000>  Latitude;
+  typedef tAISField<112,12,false,3600> COG;
+  typedef tAISField<124, 9,false,511>  Heading;
+  typedef tAISField<133, 6,false,60>   Seconds;
+  typedef tAISField<139, 2>            Regional;
+  typedef tAISField<141, 1>            Unit;
+  typedef tAISField<142, 1>            Display;
+  typedef tAISField<143, 1>            DSC;
+  typedef tAISField<144, 1>            Band;
+  typedef tAISField<145, 1>            Msg22;
+  typedef tAISField<146, 1>            Mode;
+  typedef tAISField<147, 1>            RAIM;
+  typedef tAISField<148,20>            RadioStatus;
+};
+
+//*****************************************************************************
+// Type 24: Static Data Report, Part A and Part B
+struct tAISMessage24ALayout : public tAISMessageLayout<168> {
+  typedef tAISField< 38, 2>            PartNumber;    // 0
+  typedef tAISTextField< 40,120>       Name;
+  typedef tAISField<160, 8>            Spare;
+};
+
+struct tAISMessage24BLayout : public tAISMessageLayout<168> {
+  typedef tAISField< 38, 2>            PartNumber;    // 1
+  typedef tAISField< 40, 8>            VesselType;
+  typedef tAISTextField< 48,42>        VendorID;
+  typedef tAISTextField< 90,42>        Callsign;
+  typedef tAISField<132, 9>            DimensionToBow;
+  typedef tAISField<141, 9>            DimensionToStern;
+  typedef tAISField<150, 6>            DimensionToPort;
+  typedef tAISField<156, 6>            DimensionToStbd;
+  typedef tAISField<132,30>            MothershipID;  // instead of dimensions for auxiliary craft
+  typedef tAISField<162, 6>            Spare;
+};
+
+#endif
@@ -0,0 +1,104 @@
+/*
+NMEA0183AISLineRing.h
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+// Lock free single producer / single consumer ring of output lines, e.g. N2k conversion
+// on one thread and writing to streams or sockets on another. Each slot holds one
+// push, up to SlotSize-3 characters, so AIS Message 5 with both sentences fits the
+// default 128 bytes. Head and Tail are on own cache lines, so producer and consumer
+// do not share one.
+// Header only and needs <atomic>, so it is not for AVR.
+
+#ifndef _tNMEA0183AISLineRing_H_
+#define _tNMEA0183AISLineRing_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+
+#ifndef AIS_CACHE_LINE_SIZE
+#define AIS_CACHE_LINE_SIZE 64
+#endif
+
+//*****************************************************************************
+template <uint16_t _Slots, uint16_t _SlotSize=128>
+class tAISLineRing {
+  static_assert(_Slots>=2 && (_Slots & (_Slots-1))==0, "tAISLineRing slots must be power of 2");
+  static_assert(_SlotSize>=4, "tAISLineRing slot too small");
+
+  public:
+    static const uint16_t Slots=_Slots;
+    static const size_t MaxLen=_SlotSize-3;
+
+  protected:
+    struct tSlot {
+      uint16_t Len;
+      char Text[_SlotSize-2];
+    };
+
+    // written by consumer
+    alignas(AIS_CACHE_LINE_SIZE) std::atomic<uint32_t> Head;
+    // written by producer
+    alignas(AIS_CACHE_LINE_SIZE) std::atomic<uint32_t> Tail;
+    std::atomic<uint32_t> Dropped;
+    alignas(AIS_CACHE_LINE_SIZE) tSlot Ring[_Slots];
+
+  public:
+    tAISLineRing() : Head(0), Tail(0), Dropped(0) {}
+
+    // Producer: copy Len characters to the ring. Returns false, if it is full or Text is too long.
+    bool Push(const char *Text, size_t Len) {
+      uint32_t t=Tail.load(std::memory_order_relaxed);
+      if ( Len>MaxLen || t-Head.load(std::memory_order_acquire)>=_Slots ) {
+        Dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      tSlot &Slot=Ring[t & (_Slots-1)];
+      memcpy(Slot.Text, Text, Len);
+      Slot.Text[Len]=0;
+      Slot.Len=(uint16_t)Len;
+      Tail.store(t+1, std::memory_order_release);
+      return true;
+    }
+    bool Push(const char *Text) { return Push(Text, strlen(Text)); }
+
+    // Consumer: oldest line, 0 terminated and valid until Pop(). Returns its length or 0 if ring is empty.
+    size_t Front(const char *&Text) const {
+      uint32_t h=Head.load(std::memory_order_relaxed);
+      if ( h==Tail.load(std::memory_order_acquire) ) return 0;
+      const tSlot &Slot=Ring[h & (_Slots-1)];
+      Text=Slot.Text;
+      return Slot.Len;
+    }
+    // Consumer: release line returned by Front()
+    void Pop() {
+      Head.store(Head.load(std::memory_order_relaxed)+1, std::memory_order_release);
+    }
+
+    // Lines queued, exact only on producer or consumer side
+    uint32_t Size() const { return Tail.load(std::memory_order_acquire)-Head.load(std::memory_order_acquire); }
+    uint32_t GetDroppedCount() const { return Dropped.load(std::memory_order_relaxed); }
+};
+
+#endif
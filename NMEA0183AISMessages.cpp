@@ -35,6 +35,8 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <sstream>
 #include <math.h>
 #include "NMEA0183AISMsg.h"
+#include "NMEA0183AISLayout.h"
+#include "NMEA0183AISFixedPoint.h"
 
 const double pi=3.1415926535897932384626433832795;
 const double kmhToms=1000.0/3600.0;
@@ -49,27 +51,81 @@ const double mToFeet=3.2808398950131;
 const double radsToDegMin = 60 * 360.0 / (2 * pi);    // [rad/s -> degree/minute]
 const char Prefix='!';
 
-std::vector<ship *> vships;
+//*****************************************************************************
+tAISEncoderContext &AISDefaultEncoderContext() {
+  static tAISEncoderContext Context;
+  return Context;
+}
+
+static_assert(tAISMessage5Layout::Length<=AIS_BIN_MAX_LEN, "AIS_BIN_MAX_LEN too small for Message 5");
+static_assert(tAISMessage24ALayout::Length+tAISMessage24BLayout::Length<=AIS_BIN_MAX_LEN, "AIS_BIN_MAX_LEN too small for Message 24");
 
 // ************************  Helper for AIS  ***********************************
-static bool AddMessageType(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageType);
-static bool AddRepeat(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t Repeat);
-static bool AddUserID(tNMEA0183AISMsg &NMEA0183AISMsg, uint32_t UserID);
-static bool AddIMONumber(tNMEA0183AISMsg &NMEA0183AISMsg, uint32_t &IMONumber);
-static bool AddText(tNMEA0183AISMsg &NMEA0183AISMsg, char *FieldVal, uint8_t length);
-//static bool AddVesselType(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t VesselType);
-static bool AddDimensions(tNMEA0183AISMsg &NMEA0183AISMsg, double Length, double Beam, double PosRefStbd, double PosRefBow);
-static bool AddNavStatus(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t &NavStatus);
-static bool AddROT(tNMEA0183AISMsg &NMEA0183AISMsg, double &rot);
-static bool AddSOG (tNMEA0183AISMsg &NMEA0183AISMsg, double &sog);
-static bool AddLongitude(tNMEA0183AISMsg &NMEA0183AISMsg, double &Longitude);
-static bool AddLatitude(tNMEA0183AISMsg &NMEA0183AISMsg, double &Latitude);
-static bool AddHeading (tNMEA0183AISMsg &NMEA0183AISMsg, double &heading);
-static bool AddCOG(tNMEA0183AISMsg &NMEA0183AISMsg, double cog);
-static bool AddSeconds (tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t &Seconds);
-static bool AddEPFDFixType(tNMEA0183AISMsg &NMEA0183AISMsg, tN2kGNSStype &GNSStype);
-static bool AddStaticDraught(tNMEA0183AISMsg &NMEA0183AISMsg, double &Draught);
-static bool AddETADateTime(tNMEA0183AISMsg &NMEA0183AISMsg, uint16_t &ETAdate, double &ETAtime);
+// Unit conversions. Return the AIS field value, "not available" value on invalid input.
+static uint8_t AISMessageType(uint8_t MessageType);
+static uint8_t AISRepeat(uint8_t Repeat);
+static uint32_t AISUserID(uint32_t UserID);
+static uint32_t AISIMONumber(uint32_t IMONumber);
+static uint8_t AISNavStatus(uint8_t NavStatus);
+static int8_t AISROT(double rot);
+static int16_t AISSOG(double sog);
+static int32_t AISLongitude(double Longitude);
+static int32_t AISLatitude(double Latitude);
+static uint16_t AISHeading(double heading);
+static int16_t AISCOG(double cog);
+static uint8_t AISSeconds(uint8_t Seconds);
+static uint8_t AISEPFDFixType(tN2kGNSStype GNSStype);
+static uint8_t AISStaticDraught(double Draught);
+
+// N2k raw field values -> AIS field value with integer arithmetic only. The results are
+// identical to the N2k library Parse... functions followed by the conversions above.
+static int32_t AISLatLonFromN2k(int32_t Raw, int32_t MaxRaw, int32_t NA);
+static int16_t AISSOGFromN2k(uint16_t Raw);
+static int16_t AISCOGFromN2k(uint16_t Raw);
+static uint16_t AISHeadingFromN2k(uint16_t Raw);
+static int8_t AISROTFromN2k(int16_t Raw);
+
+// Fields, which have same content in several messages
+template <class L> static void SetHeader(uint8_t *Bits, uint8_t MessageType, uint8_t Repeat, uint32_t UserID);
+template <class L> static void SetPosition(uint8_t *Bits, double Latitude, double Longitude, bool Accuracy, bool RAIM,
+                                           uint8_t Seconds, double COG, double SOG, double Heading);
+template <class L> static void SetDimensions(uint8_t *Bits, double Length, double Beam, double PosRefStbd, double PosRefBow);
+template <class L> static void SetETADateTime(uint8_t *Bits, uint16_t ETAdate, double ETAtime);
+
+// Payload encoders, Bits must be cleared and have room for the message layout
+static void EncodeMessage1(uint8_t *Bits, uint8_t MessageType, uint8_t Repeat,
+                           uint32_t UserID, double Latitude, double Longitude, bool Accuracy, bool RAIM, uint8_t Seconds,
+                           double COG, double SOG, double Heading, double ROT, uint8_t NavStatus);
+static void EncodeMessage5(uint8_t *Bits, uint8_t Repeat,
+                           uint32_t UserID, uint32_t IMONumber, const char *Callsign, const char *Name,
+                           uint8_t VesselType, double Length, double Beam, double PosRefStbd,
+                           double PosRefBow, uint16_t ETAdate,  double ETAtime, double Draught,
+                           const char *Destination, tN2kGNSStype GNSStype, uint8_t DTE);
+static void EncodeMessage18(uint8_t *Bits, uint8_t MessageID, uint8_t Repeat, uint32_t UserID,
+                            double Latitude, double Longitude, bool Accuracy, bool RAIM,
+                            uint8_t Seconds, double COG, double SOG, double Heading, tN2kAISUnit Unit,
+                            bool Display, bool DSC, bool Band, bool Msg22, bool Mode, bool State);
+static void EncodeMessage24A(uint8_t *Bits, uint8_t Repeat, uint32_t UserID, const char *ShipName);
+static void EncodeMessage24B(uint8_t *Bits, uint8_t Repeat, uint32_t UserID, uint8_t VesselType, const char *VendorID,
+                             const char *Callsign, double Length, double Beam, double PosRefStbd, double PosRefBow);
+static void EncodeMessage24(uint8_t *Bits, uint8_t Repeat, uint32_t UserID, const char *ShipName,
+                            uint8_t VesselType, const char *VendorID, const char *Callsign,
+                            double Length, double Beam, double PosRefStbd,  double PosRefBow);
+static const char *GetShipName(const tAISEncoderContext &Context, uint32_t UserID);
+
+// Keys of the input fields of the encoders above for the sentence cache
+static void Message5Key(tAISStaticKey &Key, uint8_t Repeat, uint32_t IMONumber, const char *Callsign, const char *Name,
+                        uint8_t VesselType, double Length, double Beam, double PosRefStbd,
+                        double PosRefBow, uint16_t ETAdate,  double ETAtime, double Draught,
+                        const char *Destination, tN2kGNSStype GNSStype, uint8_t DTE);
+static void Message24AKey(tAISStaticKey &Key, uint8_t Repeat, const char *ShipName);
+static void Message24BKey(tAISStaticKey &Key, uint8_t Repeat, uint8_t VesselType, const char *VendorID,
+                          const char *Callsign, double Length, double Beam, double PosRefStbd, double PosRefBow);
+
+// Payload from N2k AIS position report PGN, Bits must be cleared
+template <class L> static void SetPositionFromN2k(uint8_t *Bits, const tN2kMsg &N2kMsg, int &Index);
+static bool TranscodeN2kPGN129038(uint8_t *Bits, const tN2kMsg &N2kMsg);
+static bool TranscodeN2kPGN129039(uint8_t *Bits, const tN2kMsg &N2kMsg);
 
 //*****************************************************************************
 // Types 1, 2 and 3: Position Report Class A or B  -> https://gpsd.gitlab.io/gpsd/AIVDM.html
@@ -78,72 +134,255 @@ static bool AddETADateTime(tNMEA0183AISMsg &NMEA0183AISMsg, uint16_t &ETAdate, d
 // Payload: Payload: 133m@ogP00PD;88MD5MTDww@2D7k
 // Message type 1 has a payload length of 168 bits.
 // because AIS encodes messages using a 6-bits ASCII mechanism and 168 divided by 6 is 28.
+// Field layout see tAISMessage1Layout
 //
 // Got values from: ParseN2kPGN129038()
+bool SetAISClassABMessage1( tAISEncoderContext &Context, tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageType, uint8_t Repeat,
+			    uint32_t UserID, double Latitude, double Longitude, bool Accuracy, bool RAIM, uint8_t Seconds,
+			    double COG, double SOG, double Heading, double ROT, uint8_t NavStatus ) {
+
+  uint8_t *Bits = NMEA0183AISMsg.InitPayload(tAISMessage1Layout::Length);
+  if ( Bits == nullptr ) return false;
+  NMEA0183AISMsg.SetSequentialIDs(Context.SequentialIDs);
+
+  EncodeMessage1(Bits, MessageType, Repeat, UserID, Latitude, Longitude, Accuracy, RAIM, Seconds, COG, SOG, Heading, ROT, NavStatus);
+
+  return NMEA0183AISMsg.BuildFragment(1, 'A');
+}
+
 bool SetAISClassABMessage1( tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageType, uint8_t Repeat,
 			    uint32_t UserID, double Latitude, double Longitude, bool Accuracy, bool RAIM, uint8_t Seconds,
 			    double COG, double SOG, double Heading, double ROT, uint8_t NavStatus ) {
+  return SetAISClassABMessage1(AISDefaultEncoderContext(), NMEA0183AISMsg, MessageType, Repeat, UserID, Latitude, Longitude,
+                               Accuracy, RAIM, Seconds, COG, SOG, Heading, ROT, NavStatus);
+}
 
-  NMEA0183AISMsg.ClearAIS();
-  if ( !AddMessageType(NMEA0183AISMsg, MessageType) ) return false;    // 0 - 5    | 6    Message Type -> Constant: 1
-  if ( !AddRepeat(NMEA0183AISMsg, Repeat) ) return false;              // 6 - 7    | 2    Repeat Indicator: 0 = default; 3 = do not repeat any more
-  if ( !AddUserID(NMEA0183AISMsg, UserID) ) return false;              // 8 - 37   | 30  MMSI
-  if ( !AddNavStatus(NMEA0183AISMsg, NavStatus) ) return false;        // 38-41    | 4    Navigational Status  e.g.: "Under way sailing"
-  if ( !AddROT(NMEA0183AISMsg, ROT) ) return false;                    // 42-49    | 8    Rate of Turn (ROT)
-  if ( !AddSOG(NMEA0183AISMsg, SOG) ) return false;                    // 50-59    | 10   [m/s -> kts]  SOG with one digit  x10, 1023 = N/A
-  if ( !NMEA0183AISMsg.AddBoolToPayloadBin(Accuracy, 1) ) return false;// 60       | 1    GPS Accuracy 1 oder 0, Default 0
-  if ( !AddLongitude(NMEA0183AISMsg, Longitude) ) return false;        // 61-88    | 28  Longitude in Minutes / 10000
-  if ( !AddLatitude(NMEA0183AISMsg, Latitude) ) return false;          // 89-115   | 27  Latitude in Minutes / 10000
-  if ( !AddCOG(NMEA0183AISMsg, COG) ) return false;                    // 116-127  | 12  Course over ground will be 3600 (0xE10) if that data is not available.
-  if ( !AddHeading (NMEA0183AISMsg, Heading) ) return false;           // 128-136  |  9    True Heading (HDG)
-  if ( !AddSeconds(NMEA0183AISMsg, Seconds) ) return false;            // 137-142  | 6    Seconds in UTC timestamp)
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(0, 2) ) return false;        // 143-144  | 2    Maneuver Indicator: 0 (default) 1, 2  (not delivered within this PGN)
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(0, 3) ) return false;        // 145-147  | 3   Spare
-  if ( !NMEA0183AISMsg.AddBoolToPayloadBin(RAIM, 1) ) return false;    // 148-148  | 1   RAIM flag 0 = RAIM not in use (default), 1 = RAIM in use
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(0, 19) ) return false;       // 149-167  | 19  Radio Status  (-> 0 NOT SENT WITH THIS PGN!!!!!)
-
-  if ( !NMEA0183AISMsg.Init("VDM","AI", Prefix) ) return false;
-  if ( !NMEA0183AISMsg.AddStrField("1") ) return false;
-  if ( !NMEA0183AISMsg.AddStrField("1") ) return false;
-  if ( !NMEA0183AISMsg.AddEmptyField() ) return false;
-  if ( !NMEA0183AISMsg.AddStrField("A") ) return false;
-  if ( !NMEA0183AISMsg.AddStrField( NMEA0183AISMsg.GetPayload() ) ) return false;
-  if ( !NMEA0183AISMsg.AddStrField("0") ) return false;    // Message 1,2,3 has always Zero Padding
+size_t EncodeAISClassABMessage1To(tAISEncoderContext &Context, char *Buf, size_t BufSize, uint8_t MessageType, uint8_t Repeat,
+                                  uint32_t UserID, double Latitude, double Longitude, bool Accuracy, bool RAIM, uint8_t Seconds,
+                                  double COG, double SOG, double Heading, double ROT, uint8_t NavStatus) {
+  typedef tAISMessage1Layout L;
+  uint8_t Bits[L::Bytes] = { 0 };
 
-  return true;
+  EncodeMessage1(Bits, MessageType, Repeat, UserID, Latitude, Longitude, Accuracy, RAIM, Seconds, COG, SOG, Heading, ROT, NavStatus);
+
+  if ( Context.PositionCache != nullptr ) return Context.PositionCache->Write(Buf, BufSize, Bits, L::Length, 'A');
+  return AISWriteSentences(Buf, BufSize, Bits, L::Length, 'A');
+}
+
+size_t EncodeAISClassABMessage1To(char *Buf, size_t BufSize, uint8_t MessageType, uint8_t Repeat,
+                                  uint32_t UserID, double Latitude, double Longitude, bool Accuracy, bool RAIM, uint8_t Seconds,
+                                  double COG, double SOG, double Heading, double ROT, uint8_t NavStatus) {
+  typedef tAISMessage1Layout L;
+  uint8_t Bits[L::Bytes] = { 0 };
+
+  EncodeMessage1(Bits, MessageType, Repeat, UserID, Latitude, Longitude, Accuracy, RAIM, Seconds, COG, SOG, Heading, ROT, NavStatus);
+
+  return AISWriteSentences(Buf, BufSize, Bits, L::Length, 'A');
+}
+
+void EncodeMessage1(uint8_t *Bits, uint8_t MessageType, uint8_t Repeat,
+                    uint32_t UserID, double Latitude, double Longitude, bool Accuracy, bool RAIM, uint8_t Seconds,
+                    double COG, double SOG, double Heading, double ROT, uint8_t NavStatus) {
+  typedef tAISMessage1Layout L;
+
+  SetHeader<L>(Bits, MessageType, Repeat, UserID);
+  L::Set<L::NavStatus>(Bits, AISNavStatus(NavStatus));    // Navigational Status  e.g.: "Under way sailing"
+  L::Set<L::ROT>(Bits, AISROT(ROT));                      // Rate of Turn (ROT)
+  SetPosition<L>(Bits, Latitude, Longitude, Accuracy, RAIM, Seconds, COG, SOG, Heading);
+  // Maneuver Indicator: 0 (default), Spare and Radio Status (not delivered within this PGN) stay 0
+  // Message 1,2,3 has always Zero Padding
+}
+
+//*****************************************************************************
+// Batch encoding of Message 1, 2, 3. Unit conversions are done for a block of
+// vessels in plain loops without function calls, so the compiler can vectorize them.
+// Results are identical to the scalar helpers AISSOG(), AISCOG() etc.
+// Rounding: aRoundToInt(x) == (int32_t)(x>=0 ? x+0.5 : x-0.5) as truncation is used.
+size_t EncodeAISClassABMessage1Batch(char *Buf, size_t BufSize, const tAISPositionBatch &Batch, size_t &Encoded) {
+  typedef tAISMessage1Layout L;
+  int32_t SOG[AIS_BATCH_BLOCK];
+  int32_t COG[AIS_BATCH_BLOCK];
+  int32_t Heading[AIS_BATCH_BLOCK];
+  int32_t ROT[AIS_BATCH_BLOCK];
+  int32_t Latitude[AIS_BATCH_BLOCK];
+  int32_t Longitude[AIS_BATCH_BLOCK];
+  size_t iBuf = 0;
+
+  Encoded = 0;
+  if ( BufSize > 0 ) Buf[0] = 0;
+
+  for (size_t Block = 0; Block < Batch.Count; Block += AIS_BATCH_BLOCK) {
+    size_t n = Batch.Count - Block;
+    if ( n > AIS_BATCH_BLOCK ) n = AIS_BATCH_BLOCK;
+
+#if AIS_FIXED_POINT_CONVERSIONS
+    // Nothing to vectorize without double FPU
+    for (size_t i = 0; i < n; i++) {
+      size_t j = Block + i;
+      SOG[i] = AISSOG(Batch.SOG[j]);
+      COG[i] = AISCOG(Batch.COG[j]);
+      Heading[i] = AISHeading(Batch.Heading[j]);
+      ROT[i] = AISROT(Batch.ROT[j]);
+      Latitude[i] = AISLatitude(Batch.Latitude[j]);
+      Longitude[i] = AISLongitude(Batch.Longitude[j]);
+    }
+#else
+    const double *sog = Batch.SOG + Block;
+    for (size_t i = 0; i < n; i++) {
+      double x = sog[i] * msTokn;
+      x = ( !( sog[i] >= 0.0 ) || x > 102.2 ) ? -1.0 : 10 * x + 0.5;
+      SOG[i] = ( x < 0.0 ) ? 1023 : (int32_t) x;
+    }
+
+    const double *cog = Batch.COG + Block;
+    for (size_t i = 0; i < n; i++) {
+      double x = cog[i] * radToDeg;
+      x = ( x >= 0.0 && x < 360.0 ) ? x * 10 + 0.5 : 3600.0;
+      COG[i] = (int32_t) x;
+    }
+
+    const double *hdg = Batch.Heading + Block;
+    for (size_t i = 0; i < n; i++) {
+      double x = hdg[i] * radToDeg;
+      x = ( x >= 0.0 && x <= 359.0 ) ? x + 0.5 : 511.0;
+      Heading[i] = N2kIsNA(hdg[i]) ? 511 : (int32_t) x;
+    }
+
+    const double *rot = Batch.ROT + Block;
+    for (size_t i = 0; i < n; i++) {
+      double x = rot[i] * radsToDegMin;
+      x = ( x > -128.0 && x < 128.0 ) ? x + ( x >= 0.0 ? 0.5 : -0.5 ) : 128.0;
+      ROT[i] = N2kIsNA(rot[i]) ? 128 : (int32_t) x;
+    }
+
+    const double *lat = Batch.Latitude + Block;
+    for (size_t i = 0; i < n; i++) {
+      double x = ( lat[i] >= -90.0 && lat[i] <= 90.0 ) ? lat[i] * 600000 : 91 * 600000.0;
+      Latitude[i] = (int32_t) x;
+    }
+
+    const double *lon = Batch.Longitude + Block;
+    for (size_t i = 0; i < n; i++) {
+      double x = ( lon[i] >= -180.0 && lon[i] <= 180.0 ) ? lon[i] * 600000 : 181 * 600000.0;
+      Longitude[i] = (int32_t) x;
+    }
+#endif
+
+    for (size_t i = 0; i < n; i++) {
+      size_t j = Block + i;
+      uint8_t Bits[L::Bytes] = { 0 };
+
+      L::Set<L::MessageType>(Bits, AISMessageType( Batch.MessageType ? Batch.MessageType[j] : 1 ));
+      L::Set<L::Repeat>(Bits, AISRepeat( Batch.Repeat ? Batch.Repeat[j] : 0 ));
+      L::Set<L::UserID>(Bits, AISUserID(Batch.UserID[j]));
+      L::Set<L::NavStatus>(Bits, AISNavStatus( Batch.NavStatus ? Batch.NavStatus[j] : 15 ));
+      L::Set<L::ROT>(Bits, ROT[i]);
+      L::Set<L::SOG>(Bits, SOG[i]);
+      L::Set<L::Accuracy>(Bits, Batch.Accuracy ? Batch.Accuracy[j] : false);
+      L::Set<L::Longitude>(Bits, Longitude[i]);
+      L::Set<L::Latitude>(Bits, Latitude[i]);
+      L::Set<L::COG>(Bits, COG[i]);
+      L::Set<L::Heading>(Bits, Heading[i]);
+      L::Set<L::Seconds>(Bits, AISSeconds( Batch.Seconds ? Batch.Seconds[j] : 60 ));
+      L::Set<L::RAIM>(Bits, Batch.RAIM ? Batch.RAIM[j] : false);
+
+      size_t len = AISWriteSentences(Buf + iBuf, BufSize - iBuf, Bits, L::Length, 'A');
+      if ( len == 0 ) return iBuf;
+      iBuf += len;
+      Encoded++;
+    }
+  }
+
+  return iBuf;
 }
 
 // *****************************************************************************
 // https://www.navcen.uscg.gov/?pageName=AISMessagesAStatic#
 // AIS class A Static and Voyage Related Data
+// Field layout see tAISMessage5Layout
 // Values derived from ParseN2kPGN129794();
-bool  SetAISClassAMessage5(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat,
-                          uint32_t UserID, uint32_t IMONumber, char *Callsign, char *Name,
+bool  SetAISClassAMessage5(tAISEncoderContext &Context, tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t /*MessageID*/, uint8_t Repeat,
+                          uint32_t UserID, uint32_t IMONumber, const char *Callsign, const char *Name,
                           uint8_t VesselType, double Length, double Beam, double PosRefStbd,
                           double PosRefBow, uint16_t ETAdate,  double ETAtime, double Draught,
-                          char *Destination, tN2kGNSStype GNSStype, uint8_t DTE ) {
-
-  // AIS Type 5 Message
-  NMEA0183AISMsg.ClearAIS();
-  if ( !AddMessageType(NMEA0183AISMsg, 5) ) return false;                // 0 - 5     | 6    Message Type -> Constant: 5
-  if ( !AddRepeat(NMEA0183AISMsg, Repeat) ) return false;                // 6 - 7     | 2    Repeat Indicator: 0 = default; 3 = do not repeat any more
-  if ( !AddUserID(NMEA0183AISMsg, UserID) ) return false;                // 8 - 37    | 30  MMSI
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(1, 2) ) return false;          // 38 - 39   |  2   AIS Version  -> 0 oder 1  NOT DERIVED FROM N2k, Always 1!!!!
-  if ( !AddIMONumber(NMEA0183AISMsg, IMONumber) ) return false;          // 40 - 69   | 30   IMO Number unisgned
-  if ( !AddText(NMEA0183AISMsg, Callsign, 42) ) return false;            // 70 - 111  | 42   Call Sign  WDE4178      -> 7  6-bit characters -> Ascii lt. Table)
-  if ( !AddText(NMEA0183AISMsg, Name, 120) ) return false;               // 112-231   | 120 Vessel Name  POINT FERMIN  -> 20 6-bit characters -> Ascii lt. Table
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(VesselType, 8) ) return false; // 232-239   |   8 Ship Type  0....255 e.g. 31  Towing
-  if ( !AddDimensions(NMEA0183AISMsg, Length, Beam, PosRefStbd, PosRefBow) ) return false;  // 240 - 269 | 30 Dimensions
-  if ( !AddEPFDFixType(NMEA0183AISMsg, GNSStype) ) return false;         // 270-273   | 4  Position Fix Type, 0 (default)
-  if ( !AddETADateTime(NMEA0183AISMsg, ETAdate, ETAtime) ) return false; // 274 -293  | 20 Estimated time of arrival; MMDDHHMM UTC
-  if ( !AddStaticDraught(NMEA0183AISMsg, Draught) ) return false;        // 294-301   | 8  Maximum Present Static Draught
-  if ( !AddText(NMEA0183AISMsg, Destination, 120) ) return false;        // 302-421   | 120 | 20  Destination 20 6-bit characters
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(DTE, 1) ) return false;        // 422       | 1   | Data terminal equipment (DTE) ready (0 = available, 1 = not available = default)
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(0, 1) ) return false;          // 423       | 1   | spare
+                          const char *Destination, tN2kGNSStype GNSStype, uint8_t DTE ) {
+
+  uint8_t *Bits = NMEA0183AISMsg.InitPayload(tAISMessage5Layout::Length);
+  if ( Bits == nullptr ) return false;
+  NMEA0183AISMsg.SetSequentialIDs(Context.SequentialIDs);
+
+  EncodeMessage5(Bits, Repeat, UserID, IMONumber, Callsign, Name, VesselType, Length, Beam, PosRefStbd, PosRefBow,
+                 ETAdate, ETAtime, Draught, Destination, GNSStype, DTE);
 
   return true;
 }
 
+bool  SetAISClassAMessage5(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat,
+                          uint32_t UserID, uint32_t IMONumber, const char *Callsign, const char *Name,
+                          uint8_t VesselType, double Length, double Beam, double PosRefStbd,
+                          double PosRefBow, uint16_t ETAdate,  double ETAtime, double Draught,
+                          const char *Destination, tN2kGNSStype GNSStype, uint8_t DTE ) {
+  return SetAISClassAMessage5(AISDefaultEncoderContext(), NMEA0183AISMsg, MessageID, Repeat, UserID, IMONumber, Callsign, Name,
+                              VesselType, Length, Beam, PosRefStbd, PosRefBow, ETAdate, ETAtime, Draught, Destination, GNSStype, DTE);
+}
+
+size_t EncodeAISClassAMessage5To(tAISEncoderContext &Context, char *Buf, size_t BufSize, uint8_t /*MessageID*/, uint8_t Repeat,
+                                 uint32_t UserID, uint32_t IMONumber, const char *Callsign, const char *Name,
+                                 uint8_t VesselType, double Length, double Beam, double PosRefStbd,
+                                 double PosRefBow, uint16_t ETAdate,  double ETAtime, double Draught,
+                                 const char *Destination, tN2kGNSStype GNSStype, uint8_t DTE) {
+  typedef tAISMessage5Layout L;
+  uint8_t Bits[L::Bytes] = { 0 };
+  tAISStaticKey Key;
+
+  if ( Context.SentenceCache != nullptr ) {
+    Message5Key(Key, Repeat, IMONumber, Callsign, Name, VesselType, Length, Beam, PosRefStbd, PosRefBow,
+                ETAdate, ETAtime, Draught, Destination, GNSStype, DTE);
+    size_t len = Context.SentenceCache->Get(UserID, 5, Key, nullptr, Buf, BufSize, Context.SequentialIDs);
+    if ( len > 0 ) return len;
+  }
+
+  EncodeMessage5(Bits, Repeat, UserID, IMONumber, Callsign, Name, VesselType, Length, Beam, PosRefStbd, PosRefBow,
+                 ETAdate, ETAtime, Draught, Destination, GNSStype, DTE);
+
+  size_t len = AISWriteSentences(Buf, BufSize, Bits, L::Length, 'A', Context.SequentialIDs);
+  if ( len > 0 && Context.SentenceCache != nullptr ) {
+    Context.SentenceCache->SetSentences(UserID, 5, false, Buf, len, &Key);
+  }
+
+  return len;
+}
+
+size_t EncodeAISClassAMessage5To(char *Buf, size_t BufSize, uint8_t MessageID, uint8_t Repeat,
+                                 uint32_t UserID, uint32_t IMONumber, const char *Callsign, const char *Name,
+                                 uint8_t VesselType, double Length, double Beam, double PosRefStbd,
+                                 double PosRefBow, uint16_t ETAdate,  double ETAtime, double Draught,
+                                 const char *Destination, tN2kGNSStype GNSStype, uint8_t DTE) {
+  return EncodeAISClassAMessage5To(AISDefaultEncoderContext(), Buf, BufSize, MessageID, Repeat, UserID, IMONumber, Callsign, Name,
+                                   VesselType, Length, Beam, PosRefStbd, PosRefBow, ETAdate, ETAtime, Draught, Destination, GNSStype, DTE);
+}
+
+void EncodeMessage5(uint8_t *Bits, uint8_t Repeat,
+                    uint32_t UserID, uint32_t IMONumber, const char *Callsign, const char *Name,
+                    uint8_t VesselType, double Length, double Beam, double PosRefStbd,
+                    double PosRefBow, uint16_t ETAdate,  double ETAtime, double Draught,
+                    const char *Destination, tN2kGNSStype GNSStype, uint8_t DTE) {
+  typedef tAISMessage5Layout L;
+
+  SetHeader<L>(Bits, 5, Repeat, UserID);
+  L::Set<L::AISVersion>(Bits, 1);                         // AIS Version  -> 0 oder 1  NOT DERIVED FROM N2k, Always 1!!!!
+  L::Set<L::IMONumber>(Bits, AISIMONumber(IMONumber));
+  L::SetText<L::Callsign>(Bits, Callsign);                // Call Sign  WDE4178      -> 7  6-bit characters -> Ascii lt. Table)
+  L::SetText<L::Name>(Bits, Name);                        // Vessel Name  POINT FERMIN  -> 20 6-bit characters -> Ascii lt. Table
+  L::Set<L::VesselType>(Bits, VesselType);                // Ship Type  0....255 e.g. 31  Towing
+  SetDimensions<L>(Bits, Length, Beam, PosRefStbd, PosRefBow);
+  L::Set<L::EPFDFixType>(Bits, AISEPFDFixType(GNSStype)); // Position Fix Type, 0 (default)
+  SetETADateTime<L>(Bits, ETAdate, ETAtime);
+  L::Set<L::Draught>(Bits, AISStaticDraught(Draught));    // Maximum Present Static Draught
+  L::SetText<L::Destination>(Bits, Destination);          // Destination 20 6-bit characters
+  L::Set<L::DTE>(Bits, DTE);                              // Data terminal equipment (DTE) ready (0 = available, 1 = not available = default)
+}
+
 //  ****************************************************************************
 // AIS position report (class B 129039) -> Type 18: Standard Class B CS Position Report
 // PGN129039
@@ -153,42 +392,73 @@ bool  SetAISClassAMessage5(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, u
 //                        double &Heading, tN2kAISUnit &Unit, bool &Display, bool &DSC, bool &Band, bool &Msg22, tN2kAISMode &Mode,
 //                        bool &State)
 //  VDM, VDO (AIS VHF Data-link message 18)
+//  Field layout see tAISMessage18Layout
+bool SetAISClassBMessage18(tAISEncoderContext &Context, tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat, uint32_t UserID,
+			   double Latitude, double Longitude, bool Accuracy, bool RAIM,
+			   uint8_t Seconds, double COG, double SOG, double Heading, tN2kAISUnit Unit,
+			   bool Display, bool DSC, bool Band, bool Msg22, bool Mode, bool State) {
+
+  uint8_t *Bits = NMEA0183AISMsg.InitPayload(tAISMessage18Layout::Length);
+  if ( Bits == nullptr ) return false;
+  NMEA0183AISMsg.SetSequentialIDs(Context.SequentialIDs);
+
+  EncodeMessage18(Bits, MessageID, Repeat, UserID, Latitude, Longitude, Accuracy, RAIM, Seconds, COG, SOG, Heading,
+                  Unit, Display, DSC, Band, Msg22, Mode, State);
+
+  return NMEA0183AISMsg.BuildFragment(1, 'B');
+}
+
 bool SetAISClassBMessage18(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat, uint32_t UserID,
 			   double Latitude, double Longitude, bool Accuracy, bool RAIM,
 			   uint8_t Seconds, double COG, double SOG, double Heading, tN2kAISUnit Unit,
 			   bool Display, bool DSC, bool Band, bool Msg22, bool Mode, bool State) {
-  //
-  NMEA0183AISMsg.ClearAIS();
-  if ( !AddMessageType(NMEA0183AISMsg, MessageID) ) return false;      // 0 - 5    | 6    Message Type -> Constant: 18
-  if ( !AddRepeat(NMEA0183AISMsg, Repeat) ) return false;              // 6 - 7    | 2    Repeat Indicator: 0 = default; 3 = do not repeat any more
-  if ( !AddUserID(NMEA0183AISMsg, UserID) ) return false;              // 8 - 37   | 30  MMSI
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(0, 8) ) return false;        // 38-45    | 8   Regional Reserved
-  if ( !AddSOG(NMEA0183AISMsg, SOG) ) return false;                    // 46-55    | 10   [m/s -> kts]  SOG with one digit  x10, 1023 = N/A
-  if ( !NMEA0183AISMsg.AddBoolToPayloadBin(Accuracy, 1)) return false; // 56       | 1    GPS Accuracy 1 oder 0, Default 0
-  if ( !AddLongitude(NMEA0183AISMsg, Longitude) ) return false;        // 57-84    | 28  Longitude in Minutes / 10000
-  if ( !AddLatitude(NMEA0183AISMsg, Latitude) ) return false;          // 85-111   | 27  Latitude in Minutes / 10000
-  if ( !AddCOG(NMEA0183AISMsg, COG) ) return false;                    // 112-123  | 12  Course over ground will be 3600 (0xE10) if that data is not available.
-  if ( !AddHeading (NMEA0183AISMsg, Heading) ) return false;           // 124-132  |  9    True Heading (HDG)
-  if ( !AddSeconds(NMEA0183AISMsg, Seconds) ) return false;            // 133-138  | 6    Seconds in UTC timestamp)
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(0, 2) ) return false;        // 139-140  | 2   Regional Reserved
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(Unit, 1) ) return false;     // 141      | 1   0=Class B SOTDMA unit 1=Class B CS (Carrier Sense) unit
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(Display, 1) ) return false;  // 142      | 1    0=No visual display, 1=Has display, (Probably not reliable).
-  if ( !NMEA0183AISMsg.AddBoolToPayloadBin(DSC, 1) ) return false;     // 143      | 1    If 1, unit is attached to a VHF voice radio with DSC capability.
-  if ( !NMEA0183AISMsg.AddBoolToPayloadBin(Band, 1) ) return false;    // 144      | 1   If this flag is 1, the unit can use any part of the marine channel.
-  if ( !NMEA0183AISMsg.AddBoolToPayloadBin(Msg22, 1) ) return false;   // 145      | 1   If 1, unit can accept a channel assignment via Message Type 22.
-  if ( !NMEA0183AISMsg.AddBoolToPayloadBin(Mode, 1) ) return false;    // 146      | 1   Assigned-mode flag: 0 = autonomous mode (default), 1 = assigned mode
-  if ( !NMEA0183AISMsg.AddBoolToPayloadBin(RAIM, 1) ) return false;    // 147      | 1   as for Message Type 1,2,3
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(0, 20) ) return false;       // 148-167  | 20  Radio Status not in PGN 129039
-
-  if ( !NMEA0183AISMsg.Init("VDM","AI", Prefix) ) return false;
-  if ( !NMEA0183AISMsg.AddStrField("1") ) return false;
-  if ( !NMEA0183AISMsg.AddStrField("1") ) return false;
-  if ( !NMEA0183AISMsg.AddEmptyField() ) return false;
-  if ( !NMEA0183AISMsg.AddStrField("B") ) return false;
-  if ( !NMEA0183AISMsg.AddStrField( NMEA0183AISMsg.GetPayload() ) ) return false;
-  if ( !NMEA0183AISMsg.AddStrField("0") ) return false;    // Message 18, has always Zero Padding
+  return SetAISClassBMessage18(AISDefaultEncoderContext(), NMEA0183AISMsg, MessageID, Repeat, UserID, Latitude, Longitude,
+                               Accuracy, RAIM, Seconds, COG, SOG, Heading, Unit, Display, DSC, Band, Msg22, Mode, State);
+}
 
-  return true;
+size_t EncodeAISClassBMessage18To(tAISEncoderContext &Context, char *Buf, size_t BufSize, uint8_t MessageID, uint8_t Repeat, uint32_t UserID,
+                                  double Latitude, double Longitude, bool Accuracy, bool RAIM,
+                                  uint8_t Seconds, double COG, double SOG, double Heading, tN2kAISUnit Unit,
+                                  bool Display, bool DSC, bool Band, bool Msg22, bool Mode, bool State) {
+  typedef tAISMessage18Layout L;
+  uint8_t Bits[L::Bytes] = { 0 };
+
+  EncodeMessage18(Bits, MessageID, Repeat, UserID, Latitude, Longitude, Accuracy, RAIM, Seconds, COG, SOG, Heading,
+                  Unit, Display, DSC, Band, Msg22, Mode, State);
+
+  if ( Context.PositionCache != nullptr ) return Context.PositionCache->Write(Buf, BufSize, Bits, L::Length, 'B');
+  return AISWriteSentences(Buf, BufSize, Bits, L::Length, 'B');
+}
+
+size_t EncodeAISClassBMessage18To(char *Buf, size_t BufSize, uint8_t MessageID, uint8_t Repeat, uint32_t UserID,
+                                  double Latitude, double Longitude, bool Accuracy, bool RAIM,
+                                  uint8_t Seconds, double COG, double SOG, double Heading, tN2kAISUnit Unit,
+                                  bool Display, bool DSC, bool Band, bool Msg22, bool Mode, bool State) {
+  typedef tAISMessage18Layout L;
+  uint8_t Bits[L::Bytes] = { 0 };
+
+  EncodeMessage18(Bits, MessageID, Repeat, UserID, Latitude, Longitude, Accuracy, RAIM, Seconds, COG, SOG, Heading,
+                  Unit, Display, DSC, Band, Msg22, Mode, State);
+
+  return AISWriteSentences(Buf, BufSize, Bits, L::Length, 'B');
+}
+
+void EncodeMessage18(uint8_t *Bits, uint8_t MessageID, uint8_t Repeat, uint32_t UserID,
+                     double Latitude, double Longitude, bool Accuracy, bool RAIM,
+                     uint8_t Seconds, double COG, double SOG, double Heading, tN2kAISUnit Unit,
+                     bool Display, bool DSC, bool Band, bool Msg22, bool Mode, bool /*State*/) {
+  typedef tAISMessage18Layout L;
+
+  SetHeader<L>(Bits, MessageID, Repeat, UserID);
+  SetPosition<L>(Bits, Latitude, Longitude, Accuracy, RAIM, Seconds, COG, SOG, Heading);
+  L::Set<L::Unit>(Bits, Unit);        // 0=Class B SOTDMA unit 1=Class B CS (Carrier Sense) unit
+  L::Set<L::Display>(Bits, Display);  // 0=No visual display, 1=Has display, (Probably not reliable).
+  L::Set<L::DSC>(Bits, DSC);          // If 1, unit is attached to a VHF voice radio with DSC capability.
+  L::Set<L::Band>(Bits, Band);        // If this flag is 1, the unit can use any part of the marine channel.
+  L::Set<L::Msg22>(Bits, Msg22);      // If 1, unit can accept a channel assignment via Message Type 22.
+  L::Set<L::Mode>(Bits, Mode);        // Assigned-mode flag: 0 = autonomous mode (default), 1 = assigned mode
+  // Regional Reserved and Radio Status (not in PGN 129039) stay 0
+  // Message 18, has always Zero Padding
 }
 
 //  ****************************************************************************
@@ -211,70 +481,385 @@ bool SetAISClassBMessage18(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, u
 //
 //  PGN 129809 AIS Class B "CS" Static Data Report, Part A -> AIS VHF Data-link message 24
 //  PGN 129810 AIS Class B "CS" Static Data Report, Part B -> AIS VHF Data-link message 24
-//  ParseN2kPGN129809 (const tN2kMsg &N2kMsg, uint8_t &MessageID, tN2kAISRepeat &Repeat, uint32_t &UserID, char *Name)  -> store to vector
+//  ParseN2kPGN129809 (const tN2kMsg &N2kMsg, uint8_t &MessageID, tN2kAISRepeat &Repeat, uint32_t &UserID, char *Name)  -> store to AISShipRegistry
 //  ParseN2kPGN129810(const tN2kMsg &N2kMsg, uint8_t &MessageID, tN2kAISRepeat &Repeat, uint32_t &UserID,
 //                      uint8_t &VesselType, char *Vendor, char *Callsign, double &Length, double &Beam,
 //                      double &PosRefStbd, double &PosRefBow, uint32_t &MothershipID);
 //
-//  Part A: MessageID, Repeat, UserID, ShipName -> store in vector to call on Part B arrivals!!!
+//  Part A: MessageID, Repeat, UserID, ShipName -> encoded at once, name is also stored in AISShipRegistry
+//          for SetAISClassBMessage24 / EncodeAISClassBMessage24To, which output both parts on Part B arrivals
 //  Part B: MessageID, Repeat, UserID, VesselType (5), Callsign (5), Length & Beam, PosRefBow,.. (5)
-bool SetAISClassBMessage24PartA(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat, uint32_t UserID, char *Name) {
 
-  bool found = false;
-  for (long unsigned int i = 0; i < vships.size(); i++) {
-    if ( vships[i]->_userID == UserID ) {
-      found = true;
-      break;
-    }
-  }
-  if ( ! found ) {
-    std::string nm;
-    nm+= Name;
-    vships.push_back(new ship(UserID, nm));
-  }
+// Store Name for UserID, returns the stored one
+static const char *SetShipName(tAISEncoderContext &Context, uint32_t UserID, const char *Name) {
+  tAISShipName *Ship = Context.ShipRegistry.Insert(UserID);
+  if ( Ship == nullptr ) return Name;
+  Ship->Set(Name);
+  return Ship->Name;
+}
+
+bool SetAISClassBMessage24PartA(tAISEncoderContext &Context, tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t /*MessageID*/, uint8_t Repeat,
+                                uint32_t UserID, const char *Name) {
+
+  const char *ShipName = SetShipName(Context, UserID, Name);
+
+  uint8_t *Bits = NMEA0183AISMsg.InitPayload(tAISMessage24ALayout::Length);
+  if ( Bits == nullptr ) return false;
+  NMEA0183AISMsg.SetSequentialIDs(Context.SequentialIDs);
+
+  EncodeMessage24A(Bits, Repeat, UserID, ShipName);
+
+  return true;
+}
+
+bool SetAISClassBMessage24PartA(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat, uint32_t UserID, const char *Name) {
+  return SetAISClassBMessage24PartA(AISDefaultEncoderContext(), NMEA0183AISMsg, MessageID, Repeat, UserID, Name);
+}
+
+bool SetAISClassBMessage24PartB(tAISEncoderContext &Context, tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t /*MessageID*/, uint8_t Repeat,
+                                uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
+                                double Length, double Beam, double PosRefStbd,  double PosRefBow, uint32_t /*MothershipID*/) {
+
+  uint8_t *Bits = NMEA0183AISMsg.InitPayload(tAISMessage24BLayout::Length);
+  if ( Bits == nullptr ) return false;
+  NMEA0183AISMsg.SetSequentialIDs(Context.SequentialIDs);
+
+  EncodeMessage24B(Bits, Repeat, UserID, VesselType, VendorID, Callsign, Length, Beam, PosRefStbd, PosRefBow);
+
   return true;
 }
 
+bool SetAISClassBMessage24PartB(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat,
+                                uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
+                                double Length, double Beam, double PosRefStbd,  double PosRefBow, uint32_t MothershipID) {
+  return SetAISClassBMessage24PartB(AISDefaultEncoderContext(), NMEA0183AISMsg, MessageID, Repeat, UserID, VesselType, VendorID, Callsign,
+                                    Length, Beam, PosRefStbd, PosRefBow, MothershipID);
+}
+
 // ***************************************************************************************************************
+// Part A and Part B are chained together in PayloadBits, Part A at bit 0, Part B at bit 168.
+// Field layouts see tAISMessage24ALayout and tAISMessage24BLayout
+bool  SetAISClassBMessage24(tAISEncoderContext &Context, tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t /*MessageID*/, uint8_t Repeat,
+                          uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
+                          double Length, double Beam, double PosRefStbd,  double PosRefBow, uint32_t /*MothershipID*/ ) {
+
+  uint8_t *Bits = NMEA0183AISMsg.InitPayload(tAISMessage24ALayout::Length + tAISMessage24BLayout::Length);
+  if ( Bits == nullptr ) return false;
+  NMEA0183AISMsg.SetSequentialIDs(Context.SequentialIDs);
+
+  EncodeMessage24(Bits, Repeat, UserID, GetShipName(Context, UserID), VesselType, VendorID, Callsign, Length, Beam, PosRefStbd, PosRefBow);
+
+  return true;
+}
+
 bool  SetAISClassBMessage24(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat,
-                          uint32_t UserID, uint8_t VesselType, char *VendorID, char *Callsign,
+                          uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
                           double Length, double Beam, double PosRefStbd,  double PosRefBow, uint32_t MothershipID ) {
+  return SetAISClassBMessage24(AISDefaultEncoderContext(), NMEA0183AISMsg, MessageID, Repeat, UserID, VesselType, VendorID, Callsign,
+                               Length, Beam, PosRefStbd, PosRefBow, MothershipID);
+}
 
-  uint8_t PartNr = 0;            // Identifier for the message part number; always 0 for Part A
-  char *ShipName = (char*)" ";   // get from vector to look up for sent Messages Part A
+size_t EncodeAISClassBMessage24To(tAISEncoderContext &Context, char *Buf, size_t BufSize, uint8_t /*MessageID*/, uint8_t Repeat,
+                                  uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
+                                  double Length, double Beam, double PosRefStbd,  double PosRefBow, uint32_t /*MothershipID*/) {
+  typedef tAISMessage24ALayout LA;
+  typedef tAISMessage24BLayout LB;
+  uint8_t Bits[LA::Bytes + LB::Bytes] = { 0 };
+  const char *ShipName = GetShipName(Context, UserID);
+  tAISStaticKey KeyA, KeyB;
 
-  uint8_t i;
-  for ( i = 0; i < vships.size(); i++) {
-    if ( vships[i]->_userID == UserID ) {
-//      Serial.print("UserID gefunden: "); Serial.print(UserID);
-      ShipName = const_cast<char*>( vships[i]->_shipName.c_str() );
-//      Serial.print(" / "); Serial.println( ShipName);
-    }
+  if ( Context.SentenceCache != nullptr ) {
+    Message24AKey(KeyA, Repeat, ShipName);
+    Message24BKey(KeyB, Repeat, VesselType, VendorID, Callsign, Length, Beam, PosRefStbd, PosRefBow);
+    size_t len = Context.SentenceCache->Get(UserID, 24, KeyA, &KeyB, Buf, BufSize, Context.SequentialIDs);
+    if ( len > 0 ) return len;
+  }
+
+  EncodeMessage24(Bits, Repeat, UserID, ShipName, VesselType, VendorID, Callsign, Length, Beam, PosRefStbd, PosRefBow);
+
+  size_t len = AISWriteSentences(Buf, BufSize, Bits, LA::Length, 'A', Context.SequentialIDs);
+  if ( len == 0 ) return 0;
+  size_t lenB = AISWriteSentences(Buf + len, BufSize - len, Bits + LA::Bytes, LB::Length, 'A', Context.SequentialIDs);
+  if ( lenB == 0 ) return 0;
+
+  if ( Context.SentenceCache != nullptr ) {
+    Context.SentenceCache->SetSentences(UserID, 24, false, Buf, len, &KeyA);
+    Context.SentenceCache->SetSentences(UserID, 24, true, Buf + len, lenB, &KeyB);
+  }
+
+  return len + lenB;
+}
+
+size_t EncodeAISClassBMessage24To(char *Buf, size_t BufSize, uint8_t MessageID, uint8_t Repeat,
+                                  uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
+                                  double Length, double Beam, double PosRefStbd,  double PosRefBow, uint32_t MothershipID) {
+  return EncodeAISClassBMessage24To(AISDefaultEncoderContext(), Buf, BufSize, MessageID, Repeat, UserID, VesselType, VendorID, Callsign,
+                                    Length, Beam, PosRefStbd, PosRefBow, MothershipID);
+}
+
+size_t EncodeAISClassBMessage24PartATo(tAISEncoderContext &Context, char *Buf, size_t BufSize, uint8_t /*MessageID*/, uint8_t Repeat,
+                                       uint32_t UserID, const char *Name) {
+  typedef tAISMessage24ALayout LA;
+  uint8_t Bits[LA::Bytes] = { 0 };
+  const char *ShipName = SetShipName(Context, UserID, Name);
+  tAISStaticKey Key;
+
+  if ( Context.SentenceCache != nullptr ) {
+    Message24AKey(Key, Repeat, ShipName);
+    size_t len = Context.SentenceCache->GetPart(UserID, 24, false, Key, Buf, BufSize, Context.SequentialIDs);
+    if ( len > 0 ) return len;
+  }
+
+  EncodeMessage24A(Bits, Repeat, UserID, ShipName);
+
+  size_t len = AISWriteSentences(Buf, BufSize, Bits, LA::Length, 'A', Context.SequentialIDs);
+  if ( len > 0 && Context.SentenceCache != nullptr ) Context.SentenceCache->SetSentences(UserID, 24, false, Buf, len, &Key);
+
+  return len;
+}
+
+size_t EncodeAISClassBMessage24PartATo(char *Buf, size_t BufSize, uint8_t MessageID, uint8_t Repeat, uint32_t UserID, const char *Name) {
+  return EncodeAISClassBMessage24PartATo(AISDefaultEncoderContext(), Buf, BufSize, MessageID, Repeat, UserID, Name);
+}
+
+size_t EncodeAISClassBMessage24PartBTo(tAISEncoderContext &Context, char *Buf, size_t BufSize, uint8_t /*MessageID*/, uint8_t Repeat,
+                                       uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
+                                       double Length, double Beam, double PosRefStbd,  double PosRefBow, uint32_t /*MothershipID*/) {
+  typedef tAISMessage24BLayout LB;
+  uint8_t Bits[LB::Bytes] = { 0 };
+  tAISStaticKey Key;
+
+  if ( Context.SentenceCache != nullptr ) {
+    Message24BKey(Key, Repeat, VesselType, VendorID, Callsign, Length, Beam, PosRefStbd, PosRefBow);
+    size_t len = Context.SentenceCache->GetPart(UserID, 24, true, Key, Buf, BufSize, Context.SequentialIDs);
+    if ( len > 0 ) return len;
+  }
+
+  EncodeMessage24B(Bits, Repeat, UserID, VesselType, VendorID, Callsign, Length, Beam, PosRefStbd, PosRefBow);
+
+  size_t len = AISWriteSentences(Buf, BufSize, Bits, LB::Length, 'A', Context.SequentialIDs);
+  if ( len > 0 && Context.SentenceCache != nullptr ) Context.SentenceCache->SetSentences(UserID, 24, true, Buf, len, &Key);
+
+  return len;
+}
+
+size_t EncodeAISClassBMessage24PartBTo(char *Buf, size_t BufSize, uint8_t MessageID, uint8_t Repeat,
+                                       uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
+                                       double Length, double Beam, double PosRefStbd,  double PosRefBow, uint32_t MothershipID) {
+  return EncodeAISClassBMessage24PartBTo(AISDefaultEncoderContext(), Buf, BufSize, MessageID, Repeat, UserID, VesselType, VendorID, Callsign,
+                                         Length, Beam, PosRefStbd, PosRefBow, MothershipID);
+}
+
+// Looks up name stored with Part A, " " if not known
+const char *GetShipName(const tAISEncoderContext &Context, uint32_t UserID) {
+  const tAISShipName *Ship = Context.ShipRegistry.Find(UserID);
+
+  return ( Ship != nullptr ? Ship->Name : " " );
+}
+
+// Equal keys give equal payloads: all inputs of EncodeMessage5 except the MMSI, which is the key of the cache
+void Message5Key(tAISStaticKey &Key, uint8_t Repeat, uint32_t IMONumber, const char *Callsign, const char *Name,
+                 uint8_t VesselType, double Length, double Beam, double PosRefStbd,
+                 double PosRefBow, uint16_t ETAdate,  double ETAtime, double Draught,
+                 const char *Destination, tN2kGNSStype GNSStype, uint8_t DTE) {
+  typedef tAISMessage5Layout L;
+
+  Key.Add(Repeat).Add(IMONumber).AddText(Callsign, L::Callsign::Chars).AddText(Name, L::Name::Chars).Add(VesselType);
+  Key.Add(Length).Add(Beam).Add(PosRefStbd).Add(PosRefBow).Add(ETAdate).Add(ETAtime).Add(Draught);
+  Key.AddText(Destination, L::Destination::Chars).Add((uint8_t)GNSStype).Add(DTE);
+}
+
+void Message24AKey(tAISStaticKey &Key, uint8_t Repeat, const char *ShipName) {
+  Key.Add(Repeat).AddText(ShipName, tAISMessage24ALayout::Name::Chars);
+}
+
+void Message24BKey(tAISStaticKey &Key, uint8_t Repeat, uint8_t VesselType, const char *VendorID,
+                   const char *Callsign, double Length, double Beam, double PosRefStbd, double PosRefBow) {
+  typedef tAISMessage24BLayout LB;
+
+  Key.Add(Repeat).Add(VesselType).AddText(VendorID, LB::VendorID::Chars).AddText(Callsign, LB::Callsign::Chars);
+  Key.Add(Length).Add(Beam).Add(PosRefStbd).Add(PosRefBow);
+}
+
+void EncodeMessage24(uint8_t *Bits, uint8_t Repeat, uint32_t UserID, const char *ShipName,
+                     uint8_t VesselType, const char *VendorID, const char *Callsign,
+                     double Length, double Beam, double PosRefStbd,  double PosRefBow) {
+  EncodeMessage24A(Bits, Repeat, UserID, ShipName);
+  EncodeMessage24B(Bits + tAISMessage24ALayout::Bytes, Repeat, UserID, VesselType, VendorID, Callsign, Length, Beam, PosRefStbd, PosRefBow);
+}
+
+// Part A: 40 + 128 = len 168
+void EncodeMessage24A(uint8_t *Bits, uint8_t Repeat, uint32_t UserID, const char *ShipName) {
+  typedef tAISMessage24ALayout LA;
+
+  SetHeader<LA>(Bits, 24, Repeat, UserID);
+  LA::Set<LA::PartNumber>(Bits, 0);
+  LA::SetText<LA::Name>(Bits, ShipName);                  // Vessel Name  20 6-bit characters -> Ascii Table
+}
+
+// https://www.navcen.uscg.gov/?pageName=AISMessagesB
+// PART B: 40 + 128 = len 168
+void EncodeMessage24B(uint8_t *Bits, uint8_t Repeat, uint32_t UserID, uint8_t VesselType, const char *VendorID,
+                      const char *Callsign, double Length, double Beam, double PosRefStbd, double PosRefBow) {
+  typedef tAISMessage24BLayout LB;
+
+  SetHeader<LB>(Bits, 24, Repeat, UserID);
+  LB::Set<LB::PartNumber>(Bits, 1);
+  LB::Set<LB::VesselType>(Bits, VesselType);              // Ship Type 0....99
+  LB::SetText<LB::VendorID>(Bits, VendorID);              // Vendor ID + Unit Model Code + Serial Number
+  LB::SetText<LB::Callsign>(Bits, Callsign);              // Call Sign  WDE4178      -> 7  6-bit characters, as in Msg Type 5
+  SetDimensions<LB>(Bits, Length, Beam, PosRefStbd, PosRefBow);
+}
+
+//******************************************************************************
+// Direct transcoding of N2k AIS position reports PGN 129038 and 129039.
+// Raw N2k fields: Latitude, Longitude 1e-7 deg, COG, Heading 1e-4 rad, SOG 0.01 m/s,
+// ROT 3.125e-5 rad/s. They are converted to AIS units without floating point, which
+// is software emulated for double on many MCUs.
+bool SetAISClassABMessage1(tAISEncoderContext &Context, tNMEA0183AISMsg &NMEA0183AISMsg, const tN2kMsg &N2kMsg) {
+  if ( N2kMsg.PGN != 129038UL ) return false;
+  uint8_t *Bits = NMEA0183AISMsg.InitPayload(tAISMessage1Layout::Length);
+  if ( Bits == nullptr ) return false;
+  NMEA0183AISMsg.SetSequentialIDs(Context.SequentialIDs);
+
+  TranscodeN2kPGN129038(Bits, N2kMsg);
+
+  return NMEA0183AISMsg.BuildFragment(1, 'A');
+}
+
+bool SetAISClassABMessage1(tNMEA0183AISMsg &NMEA0183AISMsg, const tN2kMsg &N2kMsg) {
+  return SetAISClassABMessage1(AISDefaultEncoderContext(), NMEA0183AISMsg, N2kMsg);
+}
+
+size_t EncodeAISClassABMessage1To(tAISEncoderContext &Context, char *Buf, size_t BufSize, const tN2kMsg &N2kMsg) {
+  typedef tAISMessage1Layout L;
+  uint8_t Bits[L::Bytes] = { 0 };
+
+  if ( !TranscodeN2kPGN129038(Bits, N2kMsg) ) return 0;
+
+  if ( Context.PositionCache != nullptr ) return Context.PositionCache->Write(Buf, BufSize, Bits, L::Length, 'A');
+  return AISWriteSentences(Buf, BufSize, Bits, L::Length, 'A');
+}
+
+size_t EncodeAISClassABMessage1To(char *Buf, size_t BufSize, const tN2kMsg &N2kMsg) {
+  typedef tAISMessage1Layout L;
+  uint8_t Bits[L::Bytes] = { 0 };
+
+  if ( !TranscodeN2kPGN129038(Bits, N2kMsg) ) return 0;
+
+  return AISWriteSentences(Buf, BufSize, Bits, L::Length, 'A');
+}
+
+bool SetAISClassBMessage18(tAISEncoderContext &Context, tNMEA0183AISMsg &NMEA0183AISMsg, const tN2kMsg &N2kMsg) {
+  if ( N2kMsg.PGN != 129039UL ) return false;
+  uint8_t *Bits = NMEA0183AISMsg.InitPayload(tAISMessage18Layout::Length);
+  if ( Bits == nullptr ) return false;
+  NMEA0183AISMsg.SetSequentialIDs(Context.SequentialIDs);
+
+  TranscodeN2kPGN129039(Bits, N2kMsg);
+
+  return NMEA0183AISMsg.BuildFragment(1, 'B');
+}
+
+bool SetAISClassBMessage18(tNMEA0183AISMsg &NMEA0183AISMsg, const tN2kMsg &N2kMsg) {
+  return SetAISClassBMessage18(AISDefaultEncoderContext(), NMEA0183AISMsg, N2kMsg);
+}
+
+size_t EncodeAISClassBMessage18To(tAISEncoderContext &Context, char *Buf, size_t BufSize, const tN2kMsg &N2kMsg) {
+  typedef tAISMessage18Layout L;
+  uint8_t Bits[L::Bytes] = { 0 };
+
+  if ( !TranscodeN2kPGN129039(Bits, N2kMsg) ) return 0;
+
+  if ( Context.PositionCache != nullptr ) return Context.PositionCache->Write(Buf, BufSize, Bits, L::Length, 'B');
+  return AISWriteSentences(Buf, BufSize, Bits, L::Length, 'B');
+}
+
+size_t EncodeAISClassBMessage18To(char *Buf, size_t BufSize, const tN2kMsg &N2kMsg) {
+  typedef tAISMessage18Layout L;
+  uint8_t Bits[L::Bytes] = { 0 };
+
+  if ( !TranscodeN2kPGN129039(Bits, N2kMsg) ) return 0;
+
+  return AISWriteSentences(Buf, BufSize, Bits, L::Length, 'B');
+}
+
+bool AISTranscodeN2kPosition(uint8_t *Bits, uint16_t &Length, char &Channel, const tN2kMsg &N2kMsg) {
+  static_assert(tAISMessage18Layout::Bytes == AISPositionPayloadBytes, "Message 1 and 18 payload sizes differ");
+
+  memset(Bits, 0, AISPositionPayloadBytes);
+  if ( TranscodeN2kPGN129038(Bits, N2kMsg) ) {
+    Length = tAISMessage1Layout::Length;
+    Channel = 'A';
+    return true;
   }
-  if ( i > MAX_SHIP_IN_VECTOR ) {
-    vships.erase(vships.begin());
+  if ( TranscodeN2kPGN129039(Bits, N2kMsg) ) {
+    Length = tAISMessage18Layout::Length;
+    Channel = 'B';
+    return true;
   }
+  return false;
+}
 
-  // AIS Type 24 Message
-  NMEA0183AISMsg.ClearAIS();
-  // Common for PART A AND Part B Bit 0 - 39 / len 40
-  if ( !AddMessageType(NMEA0183AISMsg, 24) ) return false;                // 0 - 5    | 6    Message Type -> Constant: 24
-  if ( !AddRepeat(NMEA0183AISMsg, Repeat) ) return false;                 // 6 - 7    | 2    Repeat Indicator: 0 = default; 3 = do not repeat any more
-  if ( !AddUserID(NMEA0183AISMsg, UserID) ) return false;                 // 8 - 37   | 30  MMSI
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(PartNr, 2) ) return false;      // 38-39    | 2    Part Number 0-1 ->
-
-  // Part A: 40 + 128 = len 168
-  if ( !AddText(NMEA0183AISMsg, ShipName, 120) ) return false;            // 40-159   | 120 Vessel Name  20 6-bit characters -> Ascii Table
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(0, 8) ) return false;           // 160-167  | 8    Spare
-
-  // https://www.navcen.uscg.gov/?pageName=AISMessagesB
-  // PART B: 40 + 128 = len 168
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(VesselType, 8) ) return false;     // 168-175 | 40-47  |  8    Ship Type 0....99
-  if ( !AddText(NMEA0183AISMsg, VendorID, 42) ) return false;                // 176-217 | 48-89  | 42    Vendor ID + Unit Model Code + Serial Number
-  if ( !AddText(NMEA0183AISMsg, Callsign, 42) ) return false;                // 218-259 | 90-131 | 42   Call Sign  WDE4178      -> 7  6-bit characters, as in Msg Type 5
-  if ( !AddDimensions(NMEA0183AISMsg, Length, Beam, PosRefStbd, PosRefBow) ) return false;  // 260-289 | 132-161 | 30 Dimensions
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(0, 6) ) return false;              // 290-295 | 162-167 | 6    Spare
+// *****************************************************************************
+// Fields common to PGN 129038 and 129039 up to the heading:
+// Message ID, Repeat, UserID, Longitude, Latitude, Accuracy, RAIM, Seconds, COG, SOG,
+// Communication State, AIS transceiver information, Heading
+template <class L> void SetPositionFromN2k(uint8_t *Bits, const tN2kMsg &N2kMsg, int &Index) {
+  uint8_t vb = N2kMsg.GetByte(Index);
+  uint32_t UserID = N2kMsg.Get4ByteUInt(Index);
+  int32_t Longitude = (int32_t)N2kMsg.Get4ByteUInt(Index);
+  int32_t Latitude = (int32_t)N2kMsg.Get4ByteUInt(Index);
+  uint8_t Flags = N2kMsg.GetByte(Index);
+  uint16_t COG = N2kMsg.Get2ByteUInt(Index);
+  uint16_t SOG = N2kMsg.Get2ByteUInt(Index);
+  Index += 3;  // Communication State, AIS transceiver information
+  uint16_t Heading = N2kMsg.Get2ByteUInt(Index);
 
+  SetHeader<L>(Bits, vb & 0x3f, (vb >> 6) & 0x03, UserID);
+  L::template Set<typename L::SOG>(Bits, AISSOGFromN2k(SOG));
+  L::template Set<typename L::Accuracy>(Bits, Flags & 0x01);
+  L::template Set<typename L::Longitude>(Bits, AISLatLonFromN2k(Longitude, 1800000000, 181 * 600000));
+  L::template Set<typename L::Latitude>(Bits, AISLatLonFromN2k(Latitude, 900000000, 91 * 600000));
+  L::template Set<typename L::COG>(Bits, AISCOGFromN2k(COG));
+  L::template Set<typename L::Heading>(Bits, AISHeadingFromN2k(Heading));
+  L::template Set<typename L::Seconds>(Bits, AISSeconds((Flags >> 2) & 0x3f));
+  L::template Set<typename L::RAIM>(Bits, (Flags >> 1) & 0x01);
+}
+
+// *****************************************************************************
+// PGN 129038 -> Message Type 1, 2, 3
+bool TranscodeN2kPGN129038(uint8_t *Bits, const tN2kMsg &N2kMsg) {
+  typedef tAISMessage1Layout L;
+  if ( N2kMsg.PGN != 129038UL ) return false;
+
+  int Index = 0;
+  SetPositionFromN2k<L>(Bits, N2kMsg, Index);
+  int16_t ROT = N2kMsg.Get2ByteInt(Index);
+  uint8_t NavStatus = N2kMsg.GetByte(Index) & 0x0f;
+
+  L::Set<L::NavStatus>(Bits, AISNavStatus(NavStatus));
+  L::Set<L::ROT>(Bits, AISROTFromN2k(ROT));
+  return true;
+}
+
+// *****************************************************************************
+// PGN 129039 -> Message Type 18
+bool TranscodeN2kPGN129039(uint8_t *Bits, const tN2kMsg &N2kMsg) {
+  typedef tAISMessage18Layout L;
+  if ( N2kMsg.PGN != 129039UL ) return false;
+
+  int Index = 0;
+  SetPositionFromN2k<L>(Bits, N2kMsg, Index);
+  Index++;  // Regional Application
+  uint8_t vb = N2kMsg.GetByte(Index);
+
+  L::Set<L::Unit>(Bits, (vb >> 2) & 0x01);
+  L::Set<L::Display>(Bits, (vb >> 3) & 0x01);
+  L::Set<L::DSC>(Bits, (vb >> 4) & 0x01);
+  L::Set<L::Band>(Bits, (vb >> 5) & 0x01);
+  L::Set<L::Msg22>(Bits, (vb >> 6) & 0x01);
+  L::Set<L::Mode>(Bits, (vb >> 7) & 0x01);
   return true;
 }
 
@@ -282,31 +867,50 @@ bool  SetAISClassBMessage24(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID,
 //                 Validations and Unit Transformations
 //******************************************************************************
 
+// *****************************************************************************
+// Message Type, Repeat Indicator and MMSI
+template <class L> void SetHeader(uint8_t *Bits, uint8_t MessageType, uint8_t Repeat, uint32_t UserID) {
+  L::template Set<typename L::MessageType>(Bits, AISMessageType(MessageType));
+  L::template Set<typename L::Repeat>(Bits, AISRepeat(Repeat));
+  L::template Set<typename L::UserID>(Bits, AISUserID(UserID));
+}
+
+// *****************************************************************************
+// Position related fields of Message 1, 2, 3 and 18
+template <class L> void SetPosition(uint8_t *Bits, double Latitude, double Longitude, bool Accuracy, bool RAIM,
+                                    uint8_t Seconds, double COG, double SOG, double Heading) {
+  L::template Set<typename L::SOG>(Bits, AISSOG(SOG));                    // [m/s -> kts]  SOG with one digit  x10, 1023 = N/A
+  L::template Set<typename L::Accuracy>(Bits, Accuracy);                  // GPS Accuracy 1 oder 0, Default 0
+  L::template Set<typename L::Longitude>(Bits, AISLongitude(Longitude));  // Longitude in Minutes / 10000
+  L::template Set<typename L::Latitude>(Bits, AISLatitude(Latitude));     // Latitude in Minutes / 10000
+  L::template Set<typename L::COG>(Bits, AISCOG(COG));                    // Course over ground will be 3600 (0xE10) if that data is not available.
+  L::template Set<typename L::Heading>(Bits, AISHeading(Heading));        // True Heading (HDG)
+  L::template Set<typename L::Seconds>(Bits, AISSeconds(Seconds));        // Seconds in UTC timestamp
+  L::template Set<typename L::RAIM>(Bits, RAIM);                          // RAIM flag 0 = RAIM not in use (default), 1 = RAIM in use
+}
+
 // *****************************************************************************
 // 6bit    Message Type -> Constant: 1 or 3, 5, 24 etc.
-bool AddMessageType(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageType) {
+uint8_t AISMessageType(uint8_t MessageType) {
 
   if (MessageType < 0 || MessageType > 24  ) MessageType = 1;
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(MessageType, 6) ) return false;
-  return true;
+  return MessageType;
 }
 
 // *****************************************************************************
 // 2bit    Repeat Indicator: 0 = default; 3 = do not repeat any more
-bool AddRepeat(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t Repeat) {
+uint8_t AISRepeat(uint8_t Repeat) {
 
   if (Repeat < 0 || Repeat > 3) Repeat = 0;
-  if ( !NMEA0183AISMsg.AddIntToPayloadBin(Repeat, 2) ) return false;
-  return true;
+  return Repeat;
 }
 
 // *****************************************************************************
 // 30bit UserID = MMSI        (9 decimal digits)
-bool AddUserID(tNMEA0183AISMsg &NMEA0183AISMsg, uint32_t UserID) {
+uint32_t AISUserID(uint32_t UserID) {
 
   if (UserID < 0||UserID > 999999999) UserID = 0;
-   if ( !NMEA0183AISMsg.AddIntToPayloadBin(UserID, 30) ) return false;
-  return true;
+  return UserID;
 }
 
 // *****************************************************************************
@@ -315,22 +919,10 @@ bool AddUserID(tNMEA0183AISMsg &NMEA0183AISMsg, uint32_t UserID) {
 //  0000000001-0000999999 not used
 //  0001000000-0009999999 = valid IMO number;
 //  0010000000-1073741823 = official flag state number.
-bool AddIMONumber(tNMEA0183AISMsg &NMEA0183AISMsg, uint32_t &IMONumber) {
+uint32_t AISIMONumber(uint32_t IMONumber) {
   uint32_t iTemp;
   ( (IMONumber >= 999999 && IMONumber <= 9999999)||(IMONumber >= 10000000 && IMONumber <= 1073741823) )? iTemp = IMONumber : iTemp = 0;
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(iTemp, 30) ) return false;
-  return true;
-}
-
-// *****************************************************************************
-// 42bit Callsign alphanumeric value, max 7 six-bit characters
-// 120bit Name or Destination
-bool AddText(tNMEA0183AISMsg &NMEA0183AISMsg, char *FieldVal, uint8_t length) {
-  uint8_t len = length/6;
-
-  if ( strlen(FieldVal) > len ) FieldVal[len] = 0;
-  if ( !NMEA0183AISMsg.AddEncodedCharToPayloadBin(FieldVal, length) ) return false;
-  return true;
+  return iTemp;
 }
 
 //  *****************************************************************************
@@ -343,12 +935,40 @@ bool AddText(tNMEA0183AISMsg &NMEA0183AISMsg, char *FieldVal, uint8_t length) {
 //  the special value 511 indicates 511 meters or greater;
 //  for the dimensions to port and starboard, the special value 63 indicates 63 meters or greater.
 // 30 Bit
-bool AddDimensions(tNMEA0183AISMsg &NMEA0183AISMsg, double Length, double Beam, double PosRefStbd, double PosRefBow) {
+template <class L> void SetDimensions(uint8_t *Bits, double Length, double Beam, double PosRefStbd, double PosRefBow) {
   uint16_t _PosRefBow = 0;
-  uint16_t _PosRefStern = 0;
+  int32_t _PosRefStern = 0;
   uint16_t _PosRefStbd = 0;
-  uint16_t _PosRefPort = 0;
+  int32_t _PosRefPort = 0;
+
+  // Length and Beam are limited to 0...1023 before ceil, so NaN, infinity and huge values
+  // give defined results: NaN and N/A 0, +infinity 511 / 63, -infinity 0.
+#if AIS_FIXED_POINT_CONVERSIONS
+  tAISDouble Bow(PosRefBow), Stbd(PosRefStbd), Len(Length), Wid(Beam);
+
+  if ( Bow >= 0.0 && Bow <= 511.0 ) {
+    _PosRefBow = Bow.Ceil();
+  } else {
+    _PosRefBow = 511;
+  }
+
+  if ( Stbd >= 0.0 && Stbd <= 63.0 ) {
+    _PosRefStbd = Stbd.Ceil();
+  } else {
+    _PosRefStbd = 63;
+  }
 
+  if ( !( Len == N2kDoubleNA ) && !Len.IsNaN() ) {
+    _PosRefStern = ( Len > 1023.0 ? 1023 : ( Len < 0.0 ? 0 : Len.Ceil() ) ) - _PosRefBow;
+    if ( _PosRefStern < 0 ) _PosRefStern = 0;
+    if ( _PosRefStern > 511 ) _PosRefStern = 511;
+  }
+  if ( !( Wid == N2kDoubleNA ) && !Wid.IsNaN() ) {
+    _PosRefPort = ( Wid > 1023.0 ? 1023 : ( Wid < 0.0 ? 0 : Wid.Ceil() ) ) - _PosRefStbd;
+    if ( _PosRefPort < 0 ) _PosRefPort = 0;
+    if ( _PosRefPort > 63 ) _PosRefPort = 63;
+  }
+#else
   if ( PosRefBow >= 0.0 && PosRefBow <= 511.0 ) {
     _PosRefBow = ceil(PosRefBow);
   } else {
@@ -361,32 +981,31 @@ bool AddDimensions(tNMEA0183AISMsg &NMEA0183AISMsg, double Length, double Beam,
     _PosRefStbd = 63;
   }
 
-  if ( !N2kIsNA(Length) ) {
-    _PosRefStern = ceil( Length ) - _PosRefBow;
+  if ( !N2kIsNA(Length) && !isnan(Length) ) {
+    _PosRefStern = ( Length > 1023.0 ? 1023 : ( Length < 0.0 ? 0 : (int32_t)ceil( Length ) ) ) - _PosRefBow;
     if ( _PosRefStern < 0 ) _PosRefStern = 0;
     if ( _PosRefStern > 511 ) _PosRefStern = 511;
   }
-  if ( !N2kIsNA(Beam) ) {
-    _PosRefPort = ceil( Beam ) - _PosRefStbd;
+  if ( !N2kIsNA(Beam) && !isnan(Beam) ) {
+    _PosRefPort = ( Beam > 1023.0 ? 1023 : ( Beam < 0.0 ? 0 : (int32_t)ceil( Beam ) ) ) - _PosRefStbd;
     if ( _PosRefPort < 0 ) _PosRefPort = 0;
     if ( _PosRefPort > 63 ) _PosRefPort = 63;
   }
+#endif
 
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(_PosRefBow, 9) ) return false;
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(_PosRefStern, 9) ) return false;
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(_PosRefPort, 6) ) return false;
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(_PosRefStbd, 6) ) return false;
-  return true;
+  L::template Set<typename L::DimensionToBow>(Bits, _PosRefBow);
+  L::template Set<typename L::DimensionToStern>(Bits, _PosRefStern);
+  L::template Set<typename L::DimensionToPort>(Bits, _PosRefPort);
+  L::template Set<typename L::DimensionToStbd>(Bits, _PosRefStbd);
 }
 
 // *****************************************************************************
 // 4 Bit  Navigational Status  e.g.: "Under way sailing"
 // Same values used as in tN2kAISNavStatus, so we can use direct numbers
-bool AddNavStatus(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t &NavStatus) {
+uint8_t AISNavStatus(uint8_t NavStatus) {
   uint8_t iTemp;
   (NavStatus >= 0 && NavStatus <= 15 )? iTemp = NavStatus : iTemp = 15;
-   if ( ! NMEA0183AISMsg.AddIntToPayloadBin(iTemp, 4) ) return false;
-  return true;
+  return iTemp;
 }
 
 // *****************************************************************************
@@ -397,33 +1016,48 @@ bool AddNavStatus(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t &NavStatus) {
 //  127 = turning right at more than 5deg/30s (No TI available)
 //  -127 = turning left at more than 5deg/30s (No TI available)
 //  128 (80 hex) indicates no turn information available (default)
-bool AddROT(tNMEA0183AISMsg &NMEA0183AISMsg, double &rot) {
+int8_t AISROT(double rot) {
   int8_t iTemp;
+#if AIS_FIXED_POINT_CONVERSIONS
+  tAISDouble x(rot);
+  if ( x == N2kDoubleNA ) iTemp = 128;
+  else {
+    x = x * radsToDegMin;
+    (x > -128.0 && x < 128.0)? iTemp = x.Round() : iTemp = 128;
+  }
+#else
   if ( N2kIsNA(rot)) iTemp = 128;
   else {
     rot *= radsToDegMin;
     (rot > -128.0 && rot < 128.0)? iTemp = aRoundToInt(rot) : iTemp = 128;
   }
-
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(iTemp, 8) ) return false;
-  return true;
+#endif
+  return iTemp;
 }
 
 // *****************************************************************************
 // 10 bit [m/s -> kts]  SOG x10, 1023 = N/A
 // Speed over ground is in 0.1-knot resolution from 0 to 102 knots.
 // Value 1023 indicates speed is not available, value 1022 indicates 102.2 knots or higher.
-bool AddSOG (tNMEA0183AISMsg &NMEA0183AISMsg, double &sog) {
+int16_t AISSOG(double sog) {
   int16_t iTemp;
-  if ( sog < 0.0 ) iTemp = 1023;
+#if AIS_FIXED_POINT_CONVERSIONS
+  tAISDouble x(sog);
+  if ( !( x >= 0.0 ) ) iTemp = 1023;  // also NaN
+  else {
+    x = x * msTokn;
+    if (x > 102.2) iTemp = 1023;
+    else iTemp = ( x * 10.0 ).Round();
+  }
+#else
+  if ( !( sog >= 0.0 ) ) iTemp = 1023;  // also NaN
   else {
     sog *= msTokn;
     if (sog > 102.2) iTemp = 1023;
     else iTemp = aRoundToInt( 10 * sog );
   }
-
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(iTemp, 10) ) return false;
-  return true;
+#endif
+  return iTemp;
 }
 
 // *****************************************************************************
@@ -431,45 +1065,65 @@ bool AddSOG (tNMEA0183AISMsg &NMEA0183AISMsg, double &sog) {
 // Values up to plus or minus 180 degrees, East = positive, West = negative.
 // A value of 181 degrees (0x6791AC0 hex) indicates that longitude is not available and is the default.
 // AIS Longitude is given in in 1/10000 min; divide by 600000.0 to obtain degrees.
-bool AddLongitude(tNMEA0183AISMsg &NMEA0183AISMsg, double &Longitude) {
+int32_t AISLongitude(double Longitude) {
   int32_t iTemp;
+#if AIS_FIXED_POINT_CONVERSIONS
+  tAISDouble x(Longitude);
+  (x >= -180.0 && x <= 180.0)? iTemp = ( x * 600000.0 ).Trunc() : iTemp = 181 * 600000;
+#else
   (Longitude >= -180.0 && Longitude <= 180.0)? iTemp = (int) (Longitude * 600000) : iTemp = 181 * 600000;
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(iTemp, 28) ) return false;
-  return true;
+#endif
+  return iTemp;
 }
 
 // *****************************************************************************
 //   27 bit
 //  Values up to plus or minus 90 degrees, North = positive, South = negative.
 //   A value of 91 degrees (0x3412140 hex) indicates latitude is not available and is the default.
-bool AddLatitude(tNMEA0183AISMsg &NMEA0183AISMsg, double &Latitude) {
+int32_t AISLatitude(double Latitude) {
   int32_t iTemp;
+#if AIS_FIXED_POINT_CONVERSIONS
+  tAISDouble x(Latitude);
+  (x >= -90.0 && x <= 90.0)? iTemp = ( x * 600000.0 ).Trunc() : iTemp = 91 * 600000;
+#else
   (Latitude >= -90.0 && Latitude <= 90.0)? iTemp = (int) (Latitude * 600000) : iTemp = 91 * 600000;
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(iTemp, 27) ) return false;
-  return true;
+#endif
+  return iTemp;
 }
 
 //  ****************************************************************************
 // 9 bit True Heading (HDG) 0 to 359 degrees, 511 = not available.
-bool AddHeading (tNMEA0183AISMsg &NMEA0183AISMsg, double &heading) {
+uint16_t AISHeading(double heading) {
   uint16_t iTemp;
+#if AIS_FIXED_POINT_CONVERSIONS
+  tAISDouble x(heading);
+  if ( x == N2kDoubleNA ) iTemp = 511;
+  else {
+    x = x * radToDeg;
+    (x >= 0.0 && x <= 359.0 )? iTemp = x.Round() : iTemp = 511;
+  }
+#else
   if ( N2kIsNA(heading) ) iTemp = 511;
   else {
     heading *= radToDeg;
     (heading >= 0.0 && heading <= 359.0 )? iTemp = aRoundToInt( heading ) : iTemp = 511;
   }
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(iTemp, 9) ) return false;
-  return true;
+#endif
+  return iTemp;
 }
 
 // *****************************************************************************
 // 12bit Relative to true north, to 0.1 degree precision
-bool AddCOG(tNMEA0183AISMsg &NMEA0183AISMsg, double cog) {
+int16_t AISCOG(double cog) {
   int16_t iTemp;
+#if AIS_FIXED_POINT_CONVERSIONS
+  tAISDouble x = tAISDouble(cog) * radToDeg;
+  if ( x >= 0.0 && x < 360.0 ) { iTemp = ( x * 10.0 ).Round(); } else { iTemp = 3600; }
+#else
   cog *= radToDeg;
   if ( cog >= 0.0 && cog < 360.0 ) { iTemp = aRoundToInt( cog * 10 ); } else { iTemp = 3600; }
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(iTemp, 12) ) return false;
-  return true;
+#endif
+  return iTemp;
 }
 
 // *****************************************************************************
@@ -478,16 +1132,15 @@ bool AddCOG(tNMEA0183AISMsg &NMEA0183AISMsg, double cog) {
 // 61 if positioning system is in manual input mode
 // 62 if Electronic Position Fixing System operates in estimated (dead reckoning) mode,
 // 63 if the positioning system is inoperative.
-bool AddSeconds (tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t &Seconds) {
+uint8_t AISSeconds(uint8_t Seconds) {
   uint8_t iTemp;
   (Seconds >= 0 && Seconds <= 63 )? iTemp = Seconds : iTemp = 60;
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(iTemp, 6) ) return false;
-  return true;
+  return iTemp;
 }
 
 //  *****************************************************************************
 //  4 bit  Position Fix Type, See "EPFD Fix Types" 0 (default)
-bool AddEPFDFixType(tNMEA0183AISMsg &NMEA0183AISMsg, tN2kGNSStype &GNSStype) {
+uint8_t AISEPFDFixType(tN2kGNSStype GNSStype) {
   // Translate tN2kGNSStype to AIS conventions
   // 3 & 4 not defined in AIS -> we take 1 for GPS
   uint8_t fixType = 0;
@@ -511,22 +1164,28 @@ bool AddEPFDFixType(tNMEA0183AISMsg &NMEA0183AISMsg, tN2kGNSStype &GNSStype) {
     default:
       fixType = 0;
   }
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(fixType, 4) ) return false;
-  return true;
+  return fixType;
 }
 
 // *****************************************************************************
 // 8 bit Maxiumum present static draught
 // In 1/10 m, 255 = draught 25.5 m or greater, 0 = not available = default; in accordance with IMO Resolution A.851
-bool AddStaticDraught(tNMEA0183AISMsg &NMEA0183AISMsg, double &Draught) {
+uint8_t AISStaticDraught(double Draught) {
   uint8_t staticDraught;
+#if AIS_FIXED_POINT_CONVERSIONS
+  tAISDouble x(Draught);
+  if ( x == N2kDoubleNA ) staticDraught = 0;
+  else if ( !( x >= 0.0 ) ) staticDraught = 0;  // also NaN
+  else if (x > 25.5) staticDraught = 255;
+  else staticDraught = ( x * 10.0 ).Ceil();
+#else
   if ( N2kIsNA(Draught) ) staticDraught = 0;
-  else if (Draught < 0.0) staticDraught = 0;
+  else if ( !( Draught >= 0.0 ) ) staticDraught = 0;  // also NaN
   else if (Draught>25.5) staticDraught = 255;
   else staticDraught = (int) ceil( 10.0 * Draught);
+#endif
 
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(staticDraught, 8) ) return false;
-  return true;
+  return staticDraught;
 }
 
 // *****************************************************************************
@@ -539,7 +1198,7 @@ bool AddStaticDraught(tNMEA0183AISMsg &NMEA0183AISMsg, double &Draught) {
 // Type: Time Resolution: 0.0001 Signed: false    e.g. 36000.00
 //  N2k Field #8: ETA Date - Days since January 1, 1970 Bits: 16
 //  Units: days Type: Date Resolution: 1 Signed: false  e.g. 18184
-bool AddETADateTime(tNMEA0183AISMsg &NMEA0183AISMsg, uint16_t &ETAdate, double &ETAtime) {
+template <class L> void SetETADateTime(uint8_t *Bits, uint16_t ETAdate, double ETAtime) {
 
   uint8_t month = 0;
   uint8_t day = 0;
@@ -549,13 +1208,13 @@ bool AddETADateTime(tNMEA0183AISMsg &NMEA0183AISMsg, uint16_t &ETAdate, double &
   if (!N2kIsNA(ETAdate) && ETAdate > 0 ) {
     tmElements_t tm;
     #ifndef _Time_h
-    time_t t=NMEA0183AISMsg.daysToTime_t(ETAdate);
+    time_t t=tNMEA0183Msg::daysToTime_t(ETAdate);
     #else
     time_t t=ETAdate*86400;
     #endif
-    NMEA0183AISMsg.breakTime(t, tm);
-    month = (uint8_t) NMEA0183AISMsg.GetMonth(tm);
-    day = (uint8_t) NMEA0183AISMsg.GetDay(tm);
+    tNMEA0183Msg::breakTime(t, tm);
+    month = (uint8_t) tNMEA0183Msg::GetMonth(tm);
+    day = (uint8_t) tNMEA0183Msg::GetDay(tm);
   }
   if ( !N2kIsNA(ETAtime) && ETAtime >= 0 ) {
     double temp = ETAtime / 3600;
@@ -565,9 +1224,74 @@ bool AddETADateTime(tNMEA0183AISMsg &NMEA0183AISMsg, uint16_t &ETAdate, double &
     hour = 24;
     minute = 60;
   }
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(month, 4) ) return false;
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(day, 5) ) return false;
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(hour, 5) ) return false;
-  if ( ! NMEA0183AISMsg.AddIntToPayloadBin(minute, 6) ) return false;
-  return true;
+  L::template Set<typename L::ETAMonth>(Bits, month);
+  L::template Set<typename L::ETADay>(Bits, day);
+  L::template Set<typename L::ETAHour>(Bits, hour);
+  L::template Set<typename L::ETAMinute>(Bits, minute);
+}
+
+//******************************************************************************
+//        Unit Transformations of raw N2k values, integer arithmetic only
+//******************************************************************************
+
+// *****************************************************************************
+// For n a multiple of 50 the exact value n * 1e-7 * 600000 = 3n/50 is an integer.
+// Parse... and AISLatitude() / AISLongitude() calculate (int)((n * 1e-7) * 600000) in double,
+// which gives one less, if the rounded double product is just below 3n/50.
+// Emulate both IEEE 754 double multiplications to find that out.
+static bool AISLatLonRoundsDown(uint32_t n) {
+  return ( tAISDouble::FromUInt(n) * 1e-7 * 600000.0 ).Trunc() < (int32_t)( n / 50 * 3 );
+}
+
+// *****************************************************************************
+// 1e-7 deg -> 1/10000 min, truncated like AISLatitude() / AISLongitude().
+// MaxRaw is the largest raw value, which is not above 90 or 180 deg as double.
+int32_t AISLatLonFromN2k(int32_t Raw, int32_t MaxRaw, int32_t NA) {
+  if ( Raw == 0x7fffffff || Raw > MaxRaw || Raw < -MaxRaw ) return NA;
+
+  uint32_t n = ( Raw < 0 ? 0 - (uint32_t)Raw : (uint32_t)Raw );
+  int32_t Value = n / 50 * 3 + n % 50 * 3 / 50;
+  // Otherwise 3n/50 is at least 0.02 away from an integer, far more than the double rounding error
+  if ( n % 50 == 0 && n != 0 && AISLatLonRoundsDown(n) ) Value--;
+
+  return ( Raw < 0 ? -Value : Value );
+}
+
+// *****************************************************************************
+// 0.01 m/s -> 0.1 kn: Raw * 0.01 * 3600 / 1852 * 10 = Raw * 90 / 463, rounded.
+// 5257 is the largest value not above 102.2 kn.
+int16_t AISSOGFromN2k(uint16_t Raw) {
+  if ( Raw > 5257 ) return 1023;  // also N/A 0xffff
+  return ( (uint32_t)Raw * 180 + 463 ) / 926;
+}
+
+// *****************************************************************************
+// Raw * Factor rounded, Factor in 1/2^48. Raw < 2^16 and Factor < 2^47, so no overflow.
+static inline uint32_t AISRoundFixed48(uint32_t Raw, uint64_t Factor) {
+  return (uint32_t)( ( Raw * Factor + ( (uint64_t)1 << 47 ) ) >> 48 );
+}
+
+// *****************************************************************************
+// 1e-4 rad -> 0.1 deg: Raw * 0.18/pi. 62831 is the largest value below 360 deg.
+int16_t AISCOGFromN2k(uint16_t Raw) {
+  if ( Raw > 62831 ) return 3600;  // also N/A 0xffff
+  return AISRoundFixed48(Raw, 0xeaaefab3520ULL);  // 0.18/pi * 2^48
+}
+
+// *****************************************************************************
+// 1e-4 rad -> deg: Raw * 0.018/pi. 62657 is the largest value not above 359 deg.
+uint16_t AISHeadingFromN2k(uint16_t Raw) {
+  if ( Raw > 62657 ) return 511;  // also N/A 0xffff
+  return AISRoundFixed48(Raw, 0x1777e5debb6ULL);  // 0.018/pi * 2^48
+}
+
+// *****************************************************************************
+// 3.125e-5 rad/s -> deg/min: Raw * 0.3375/pi, rounded away from zero.
+// 1191 is the largest magnitude below 128 deg/min.
+int8_t AISROTFromN2k(int16_t Raw) {
+  if ( Raw == 0x7fff ) return -128;  // 128 = N/A
+  uint16_t n = ( Raw < 0 ? -(int32_t)Raw : Raw );
+  if ( n > 1191 ) return -128;
+  int8_t Value = AISRoundFixed48(n, 0x1b808161039bULL);  // 0.3375/pi * 2^48
+  return ( Raw < 0 ? -Value : Value );
 }
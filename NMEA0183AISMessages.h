@@ -31,37 +31,66 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <time.h>
 #include <string.h>
 #include <N2kTypes.h>
+#include <N2kMsg.h>
 #include "NMEA0183AISMsg.h"
+#include "NMEA0183AISLayout.h"
+#include "NMEA0183AISRegistry.h"
+#include "NMEA0183AISSentenceCache.h"
 #include <stddef.h>
-#include <vector>
-#include <string>
 
-#define MAX_SHIP_IN_VECTOR 200
-class ship {
-public:
-    uint32_t _userID;
-    std::string _shipName;
-
-    ship(uint32_t UserID, std::string ShipName) :  _userID(UserID), _shipName(ShipName) {}
+//*****************************************************************************
+// Encoder state: Class B ship names received with Message 24 Part A and
+// sequential message IDs for multi sentence messages.
+// With SentenceCache set, EncodeAISClassAMessage5To and EncodeAISClassBMessage24To
+// store their sentences there and output them again without encoding, as long as
+// the input values of a target do not change.
+// With PositionCache set, EncodeAISClassABMessage1To and EncodeAISClassBMessage18To
+// patch the previous sentence of a target instead of writing a new one.
+// Functions working on different contexts do not share any data, so use one
+// context per thread or N2k bus.
+class tAISEncoderContext {
+  public:
+    tAISShipRegistry ShipRegistry;
+    tAISSequentialIDs SequentialIDs;
+    tAISStaticSentenceCache *SentenceCache;
+    tAISPositionSentenceCache *PositionCache;
+
+    tAISEncoderContext() : SentenceCache(0), PositionCache(0) {}
+
+    void Clear() { ShipRegistry.Clear(); }
 };
 
-extern std::vector<ship *> vships;
+// Used by all functions without context parameter. It is created on first use, so
+// programs using only own contexts do not have it in RAM.
+tAISEncoderContext &AISDefaultEncoderContext();
 
 // Types 1, 2 and 3: Position Report Class A or B
+bool SetAISClassABMessage1(tAISEncoderContext &Context, tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageType, uint8_t Repeat,
+			   uint32_t UserID, double Latitude, double Longitude, bool Accuracy, bool RAIM, uint8_t Seconds,
+			   double COG, double SOG, double Heading, double ROT, uint8_t NavStatus);
 bool SetAISClassABMessage1(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageType, uint8_t Repeat,
 			   uint32_t UserID, double Latitude, double Longitude, bool Accuracy, bool RAIM, uint8_t Seconds,
 			   double COG, double SOG, double Heading, double ROT, uint8_t NavStatus);
 
 //*****************************************************************************
 // AIS Class A Static and Voyage Related Data Message Type 5
+bool SetAISClassAMessage5(tAISEncoderContext &Context, tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat,
+                          uint32_t UserID, uint32_t IMONumber, const char *Callsign, const char *Name,
+                          uint8_t VesselType, double Length, double Beam, double PosRefStbd,
+                          double PosRefBow, uint16_t ETAdate,  double ETAtime, double Draught,
+                          const char *Destination, tN2kGNSStype GNSStype, uint8_t DTE );
 bool SetAISClassAMessage5(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat,
-                          uint32_t UserID, uint32_t IMONumber, char *Callsign, char *Name,
+                          uint32_t UserID, uint32_t IMONumber, const char *Callsign, const char *Name,
                           uint8_t VesselType, double Length, double Beam, double PosRefStbd,
                           double PosRefBow, uint16_t ETAdate,  double ETAtime, double Draught,
-                          char *Destination, tN2kGNSStype GNSStype, uint8_t DTE );
+                          const char *Destination, tN2kGNSStype GNSStype, uint8_t DTE );
 
 //*****************************************************************************
 // AIS position report (class B 129039) -> Standard Class B CS Position Report Message Type 18 Part B
+bool SetAISClassBMessage18(tAISEncoderContext &Context, tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat, uint32_t UserID,
+			   double Latitude, double Longitude, bool Accuracy, bool RAIM,
+			   uint8_t Seconds, double COG, double SOG, double Heading, tN2kAISUnit Unit,
+			   bool Display, bool DSC, bool Band, bool Msg22, bool Mode, bool State);
 bool SetAISClassBMessage18(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat, uint32_t UserID,
 			   double Latitude, double Longitude, bool Accuracy, bool RAIM,
 			   uint8_t Seconds, double COG, double SOG, double Heading, tN2kAISUnit Unit,
@@ -70,14 +99,136 @@ bool SetAISClassBMessage18(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, u
 //*****************************************************************************
 // Static Data Report Class B, Message Type 24
 // PGN 129809 Handle AIS Class B "CS" Static Data Report, Part A
-bool SetAISClassBMessage24PartA(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat, uint32_t UserID, char *Name);
+// Builds Part A alone (BuildMsg24PartA) and stores the name for SetAISClassBMessage24
+bool SetAISClassBMessage24PartA(tAISEncoderContext &Context, tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat,
+                                uint32_t UserID, const char *Name);
+bool SetAISClassBMessage24PartA(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat, uint32_t UserID, const char *Name);
+// PGN 129810 Part B alone, without the name of Part A
+bool SetAISClassBMessage24PartB(tAISEncoderContext &Context, tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat,
+                                uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
+                                double Length, double Beam, double PosRefStbd,  double PosRefBow, uint32_t MothershipID);
+bool SetAISClassBMessage24PartB(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat,
+                                uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
+                                double Length, double Beam, double PosRefStbd,  double PosRefBow, uint32_t MothershipID);
 
 //*****************************************************************************
 // Static Data Report Class B, Message Type 24
+bool  SetAISClassBMessage24(tAISEncoderContext &Context, tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat,
+                          uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
+                           double Length, double Beam, double PosRefStbd,  double PosRefBow, uint32_t MothershipID );
 bool  SetAISClassBMessage24(tNMEA0183AISMsg &NMEA0183AISMsg, uint8_t MessageID, uint8_t Repeat,
-                          uint32_t UserID, uint8_t VesselType, char *VendorID, char *Callsign,
+                          uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
                            double Length, double Beam, double PosRefStbd,  double PosRefBow, uint32_t MothershipID );
 
+//*****************************************************************************
+// Direct sentence output. Encode the message and write the complete
+// "!AIVDM,...*hh\r\n" sentence(s) to Buf, no tNMEA0183Msg is needed.
+// Returns length written or 0 if Buf is too small. Message 24 writes Part A and Part B,
+// Message 5 two sentences. Buffer sizes needed, including terminating 0:
+const size_t AISMessage1BufSize=AISSentencesBufSize(tAISMessage1Layout::Length);
+const size_t AISMessage5BufSize=AISSentencesBufSize(tAISMessage5Layout::Length);
+const size_t AISMessage18BufSize=AISSentencesBufSize(tAISMessage18Layout::Length);
+const size_t AISMessage24BufSize=AISSentencesBufSize(tAISMessage24ALayout::Length)-1+AISSentencesBufSize(tAISMessage24BLayout::Length);
+const size_t AISMessage24PartBufSize=AISSentencesBufSize(tAISMessage24ALayout::Length);
+
+size_t EncodeAISClassABMessage1To(tAISEncoderContext &Context, char *Buf, size_t BufSize, uint8_t MessageType, uint8_t Repeat,
+                                  uint32_t UserID, double Latitude, double Longitude, bool Accuracy, bool RAIM, uint8_t Seconds,
+                                  double COG, double SOG, double Heading, double ROT, uint8_t NavStatus);
+size_t EncodeAISClassABMessage1To(char *Buf, size_t BufSize, uint8_t MessageType, uint8_t Repeat,
+                                  uint32_t UserID, double Latitude, double Longitude, bool Accuracy, bool RAIM, uint8_t Seconds,
+                                  double COG, double SOG, double Heading, double ROT, uint8_t NavStatus);
+
+size_t EncodeAISClassAMessage5To(tAISEncoderContext &Context, char *Buf, size_t BufSize, uint8_t MessageID, uint8_t Repeat,
+                                 uint32_t UserID, uint32_t IMONumber, const char *Callsign, const char *Name,
+                                 uint8_t VesselType, double Length, double Beam, double PosRefStbd,
+                                 double PosRefBow, uint16_t ETAdate,  double ETAtime, double Draught,
+                                 const char *Destination, tN2kGNSStype GNSStype, uint8_t DTE);
+size_t EncodeAISClassAMessage5To(char *Buf, size_t BufSize, uint8_t MessageID, uint8_t Repeat,
+                                 uint32_t UserID, uint32_t IMONumber, const char *Callsign, const char *Name,
+                                 uint8_t VesselType, double Length, double Beam, double PosRefStbd,
+                                 double PosRefBow, uint16_t ETAdate,  double ETAtime, double Draught,
+                                 const char *Destination, tN2kGNSStype GNSStype, uint8_t DTE);
+
+size_t EncodeAISClassBMessage18To(tAISEncoderContext &Context, char *Buf, size_t BufSize, uint8_t MessageID, uint8_t Repeat, uint32_t UserID,
+                                  double Latitude, double Longitude, bool Accuracy, bool RAIM,
+                                  uint8_t Seconds, double COG, double SOG, double Heading, tN2kAISUnit Unit,
+                                  bool Display, bool DSC, bool Band, bool Msg22, bool Mode, bool State);
+size_t EncodeAISClassBMessage18To(char *Buf, size_t BufSize, uint8_t MessageID, uint8_t Repeat, uint32_t UserID,
+                                  double Latitude, double Longitude, bool Accuracy, bool RAIM,
+                                  uint8_t Seconds, double COG, double SOG, double Heading, tN2kAISUnit Unit,
+                                  bool Display, bool DSC, bool Band, bool Msg22, bool Mode, bool State);
+
+size_t EncodeAISClassBMessage24To(tAISEncoderContext &Context, char *Buf, size_t BufSize, uint8_t MessageID, uint8_t Repeat,
+                                  uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
+                                  double Length, double Beam, double PosRefStbd,  double PosRefBow, uint32_t MothershipID);
+size_t EncodeAISClassBMessage24To(char *Buf, size_t BufSize, uint8_t MessageID, uint8_t Repeat,
+                                  uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
+                                  double Length, double Beam, double PosRefStbd,  double PosRefBow, uint32_t MothershipID);
+
+// Message 24 Part A on PGN 129809 and Part B on PGN 129810, each sent as soon as it arrives.
+// Part A also stores the name for EncodeAISClassBMessage24To.
+size_t EncodeAISClassBMessage24PartATo(tAISEncoderContext &Context, char *Buf, size_t BufSize, uint8_t MessageID, uint8_t Repeat,
+                                       uint32_t UserID, const char *Name);
+size_t EncodeAISClassBMessage24PartATo(char *Buf, size_t BufSize, uint8_t MessageID, uint8_t Repeat, uint32_t UserID, const char *Name);
+size_t EncodeAISClassBMessage24PartBTo(tAISEncoderContext &Context, char *Buf, size_t BufSize, uint8_t MessageID, uint8_t Repeat,
+                                       uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
+                                       double Length, double Beam, double PosRefStbd,  double PosRefBow, uint32_t MothershipID);
+size_t EncodeAISClassBMessage24PartBTo(char *Buf, size_t BufSize, uint8_t MessageID, uint8_t Repeat,
+                                       uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
+                                       double Length, double Beam, double PosRefStbd,  double PosRefBow, uint32_t MothershipID);
+
+//*****************************************************************************
+// Direct transcoding of N2k AIS position reports PGN 129038 (Message Type 1, 2, 3)
+// and PGN 129039 (Message Type 18). The raw fields of N2kMsg are converted to AIS units
+// in integer arithmetic, without ParseN2kPGN... and double values. Results are identical
+// to parsing the PGN and calling the functions above with the parsed values.
+// Return false / 0 for other PGNs.
+bool SetAISClassABMessage1(tAISEncoderContext &Context, tNMEA0183AISMsg &NMEA0183AISMsg, const tN2kMsg &N2kMsg);
+bool SetAISClassABMessage1(tNMEA0183AISMsg &NMEA0183AISMsg, const tN2kMsg &N2kMsg);
+size_t EncodeAISClassABMessage1To(tAISEncoderContext &Context, char *Buf, size_t BufSize, const tN2kMsg &N2kMsg);
+size_t EncodeAISClassABMessage1To(char *Buf, size_t BufSize, const tN2kMsg &N2kMsg);
+
+bool SetAISClassBMessage18(tAISEncoderContext &Context, tNMEA0183AISMsg &NMEA0183AISMsg, const tN2kMsg &N2kMsg);
+bool SetAISClassBMessage18(tNMEA0183AISMsg &NMEA0183AISMsg, const tN2kMsg &N2kMsg);
+size_t EncodeAISClassBMessage18To(tAISEncoderContext &Context, char *Buf, size_t BufSize, const tN2kMsg &N2kMsg);
+size_t EncodeAISClassBMessage18To(char *Buf, size_t BufSize, const tN2kMsg &N2kMsg);
+
+// Payload bits of PGN 129038 or 129039 only, for own handling of the bits, e.g. with
+// tAISPositionSentenceCache::Write(). Bits must hold AISPositionPayloadBytes bytes. Length is set to the
+// payload bit count and Channel to the channel of the functions above: 'A' for Message 1, 2, 3,
+// 'B' for Message 18.
+const size_t AISPositionPayloadBytes=tAISMessage1Layout::Bytes;
+bool AISTranscodeN2kPosition(uint8_t *Bits, uint16_t &Length, char &Channel, const tN2kMsg &N2kMsg);
+
+//*****************************************************************************
+// Batch encoding of Position Reports Message Type 1, 2, 3 for Count vessels.
+// Values are given as arrays (structure of arrays) in the units of SetAISClassABMessage1.
+// Optional arrays may be nullptr, then the default in brackets is used.
+#ifndef AIS_BATCH_BLOCK
+#define AIS_BATCH_BLOCK 64  // vessels converted together
+#endif
+
+struct tAISPositionBatch {
+  size_t Count;
+  const uint32_t *UserID;
+  const double *Latitude;
+  const double *Longitude;
+  const double *SOG;
+  const double *COG;
+  const double *Heading;
+  const double *ROT;
+  const uint8_t *MessageType;  // optional (1)
+  const uint8_t *Repeat;       // optional (0)
+  const uint8_t *NavStatus;    // optional (15 = not defined)
+  const uint8_t *Seconds;      // optional (60 = not available)
+  const bool *Accuracy;        // optional (false)
+  const bool *RAIM;            // optional (false)
+};
+
+// Write one sentence per vessel to Buf. Encoded returns number of vessels written,
+// which is less than Count, if Buf is too small. Returns length written.
+size_t EncodeAISClassABMessage1Batch(char *Buf, size_t BufSize, const tAISPositionBatch &Batch, size_t &Encoded);
+
 inline int32_t aRoundToInt(double x) {
   return x >= 0
       ? (int32_t) floor(x + 0.5)
@@ -32,56 +32,78 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <cstdio>
 #include <sstream>
 
-const char AsciiChar[] = "@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_ !\"#$%&\'()*+,-./0123456789:;<=>?";
 const char *tNMEA0183AISMsg::EmptyAISField = "000000";
 
+// Used, if caller does not provide own sequential IDs
+static tAISSequentialIDs DefaultSequentialIDs;
+
+//*****************************************************************************
+uint8_t tAISSequentialIDs::Get(char Channel) {
+  std::atomic<uint8_t> &Next=NextID[ Channel=='B' ? 1 : 0 ];
+  uint8_t ID=Next.load();
+  while ( !Next.compare_exchange_weak(ID, (ID + 1) % 10) );
+  return ID;
+}
+
 //*****************************************************************************
 tNMEA0183AISMsg::tNMEA0183AISMsg() {
+  SequentialIDs=&DefaultSequentialIDs;
   ClearAIS();
 }
 
 //*****************************************************************************
 void tNMEA0183AISMsg::ClearAIS() {
 
-  PayloadBin[0]=0;
+  memset(PayloadBits, 0, sizeof(PayloadBits));
   Payload[0]=0;
   iAddPldBin=0;
   iAddPld=0;
+  SequentialID=-1;
+}
+
+//*****************************************************************************
+uint8_t *tNMEA0183AISMsg::InitPayload(uint16_t Length) {
+
+  if ( Length > AIS_BIN_MAX_LEN ) return nullptr;
+
+  ClearAIS();
+  iAddPldBin=Length;
+
+  return PayloadBits;
 }
 
 //*****************************************************************************
 // Add 6bit with no data.
 bool tNMEA0183AISMsg::AddEmptyFieldToPayloadBin(uint8_t iBits) {
 
-  if ( (iAddPldBin + iBits * 6) >= AIS_BIN_MAX_LEN ) return false; // Is there room for any data
+  if ( (iAddPldBin + iBits * 6) > AIS_BIN_MAX_LEN ) return false; // Is there room for any data
 
-  for (uint8_t i=0;i<iBits;i++) {
-    strncpy(PayloadBin+iAddPldBin, EmptyAISField, 6);
-    iAddPldBin+=6;
-  }
+  iAddPldBin+=iBits * 6;  // PayloadBits is cleared, so we just skip the bits
 
   return true;
 }
 
 //*****************************************************************************
+// Fields are OR'ed into the packed PayloadBits. Negative values are written in
+// two's complement with countBits width.
 bool tNMEA0183AISMsg::AddIntToPayloadBin(int32_t ival, uint16_t countBits) {
 
-  if ( (iAddPldBin + countBits ) >= AIS_BIN_MAX_LEN ) return false; // Is there room for any data
-
-  bset = ival;
-
-  PayloadBin[iAddPldBin]=0;
-  uint16_t iAdd=iAddPldBin;
+  if ( (iAddPldBin + countBits ) > AIS_BIN_MAX_LEN ) return false; // Is there room for any data
 
-  char buf[2];
-  for(int i = countBits-1; i >= 0 ; i--) {
-    snprintf(buf, sizeof(buf), "%d", (int) bset[i]);
-    PayloadBin[iAdd] = buf[0];
-    iAdd++;
+  uint64_t val=(uint64_t)(int64_t)ival;
+  if ( countBits > 64 ) {     // bits above 63 are always 0
+    iAddPldBin += countBits - 64;
+    countBits = 64;
+  }
+  if ( countBits > 32 ) {
+    AISSetBits(PayloadBits, iAddPldBin, countBits - 32, (uint32_t)(val >> 32));
+    iAddPldBin += countBits - 32;
+    countBits = 32;
+  }
+  if ( countBits > 0 ) {
+    AISSetBits(PayloadBits, iAddPldBin, countBits, (uint32_t)val);
+    iAddPldBin += countBits;
   }
-
-  iAddPldBin += countBits;
-  PayloadBin[iAddPldBin]=0;
 
   return true;
 }
@@ -97,93 +119,198 @@ bool tNMEA0183AISMsg::AddBoolToPayloadBin(bool &bval, uint8_t size) {
 // *****************************************************************************
 // converts sval into binary 6-bit AScii encoded string and appends it to PayloadBin
 // filled up with "@" == "000000" to given bit-size
-bool tNMEA0183AISMsg::AddEncodedCharToPayloadBin(char *sval, size_t countBits) {
-
-  if ( (iAddPldBin + countBits ) >= AIS_BIN_MAX_LEN ) return false; // Is there room for any data
-
-  PayloadBin[iAddPldBin]=0;
-  std::bitset<6> bs;
-  const char * ptr;
-  size_t len = strlen(sval);  // e.g.: should be 7 for Callsign
-  if ( len * 6 > countBits ) len = countBits / 6;
-
-  for (size_t i = 0; i<len; i++) {
-
-    ptr = strchr(AsciiChar, sval[i]);
-    if ( ptr ) {
-      int16_t index = ptr - AsciiChar;
-      if (index >= 0){
-        AddIntToPayloadBin(index, 6);
-      }
-    } else {
-      AddIntToPayloadBin(0, 6);
-    }
-  }
+bool tNMEA0183AISMsg::AddEncodedCharToPayloadBin(const char *sval, size_t countBits) {
 
-  PayloadBin[iAddPldBin+1]=0;
+  if ( (iAddPldBin + countBits ) > AIS_BIN_MAX_LEN ) return false; // Is there room for any data
+
+  AISSetText(PayloadBits, iAddPldBin, countBits / 6, sval);
+  iAddPldBin += countBits / 6 * 6;
 
-  // fill up with "@", also covers empty sval
-  if ( len * 6 < countBits ) {
-    for (size_t i=0;i<(countBits/6-len);i++) {
-      AddIntToPayloadBin(0, 6);
-    }
-  }
-  PayloadBin[iAddPldBin]=0;
   return true;
 }
 
+//*****************************************************************************
+// Debug helper: '0'/'1' representation of the packed payload
+const char *tNMEA0183AISMsg::GetPayloadBin(char *Buf, size_t BufSize) const {
+  if ( BufSize <= iAddPldBin ) return nullptr;
+
+  uint16_t i;
+  for (i=0; i<iAddPldBin; i++) {
+    Buf[i] = AISGetBits(PayloadBits, i, 1) ? '1' : '0';
+  }
+  Buf[i]=0;
+  return Buf;
+}
+
 //*****************************************************************************
 bool tNMEA0183AISMsg::ConvertBinaryAISPayloadBinToAscii(const char *payloadbin) {
   uint16_t len;
 
   len = strlen( payloadbin ) / 6;  // 28
-  uint32_t offset;
-  char s[7];
-  uint8_t dec;
+  if ( len >= AIS_MSG_MAX_LEN ) return false;
+
   int i;
   for ( i=0; i<len; i++ ) {
-    offset = i * 6;
-    int k = 0;
-    for (uint32_t j=offset; j<offset+6; j++ ) {
-      s[k] = payloadbin[j];
-       k++;
+    const char *s = payloadbin + i * 6;
+    uint8_t dec = 0;
+    for (uint8_t j=0; j<6; j++ ) {
+      dec = (dec << 1) | (s[j] == '1');
     }
-    s[k]=0;
-    dec = strtoull (s, NULL, 2);  //binToDec
-
-    if (dec < 40 ) dec += 48;
-    else dec += 56;
-    char c = dec;
-    Payload[i] = c;
+    Payload[i] = AISArmorChars[dec];
   }
   Payload[i]=0;
 
   return true;
 }
 
+//*****************************************************************************
+// Armor Length bits of packed Bits starting at bit Start into Payload.
+// Last character will be filled up with 0 bits, if Length is not multiple of 6.
+bool tNMEA0183AISMsg::ConvertBinaryAISPayloadToAscii(const uint8_t *Bits, uint16_t Start, uint16_t Length) {
+  if ( (Length + 5) / 6 >= AIS_MSG_MAX_LEN ) return false;
+
+  AISArmorBits(Payload, Bits, Start, Length);
+
+  return true;
+}
+
+//**********************  BUILD multi sentence AIS Messages  ******************
+uint8_t tNMEA0183AISMsg::GetFragmentCount() const {
+  uint16_t len = ( iAddPldBin + 5 ) / 6;
+  return ( len + AIS_MAX_FRAGMENT_LEN - 1 ) / AIS_MAX_FRAGMENT_LEN;
+}
+
+//******************************************************************************
+// Armored payload of fragment. Fill bits are set for last fragment only.
+const char *tNMEA0183AISMsg::GetFragmentPayload(uint8_t Fragment, uint8_t &FillBits) {
+  uint8_t Count = GetFragmentCount();
+  if ( Fragment < 1 || Fragment > Count ) return nullptr;
+
+  uint16_t Start = ( Fragment - 1 ) * AIS_MAX_FRAGMENT_LEN * 6;
+  uint16_t Length = iAddPldBin - Start;
+  if ( Length > AIS_MAX_FRAGMENT_LEN * 6 ) Length = AIS_MAX_FRAGMENT_LEN * 6;
+  FillBits = ( 6 - Length % 6 ) % 6;
+
+  if ( !ConvertBinaryAISPayloadToAscii( PayloadBits, Start, Length ) ) return nullptr;
+  return Payload;
+}
+
+//******************************************************************************
+bool tNMEA0183AISMsg::BuildFragment(uint8_t Fragment, char Channel, tAISSequentialIDs &SequentialIDs) {
+  uint8_t Count = GetFragmentCount();
+  uint8_t FillBits;
+  char Field[2] = { 0, 0 };
+
+  if ( Count > 9 ) return false;
+  if ( Count > 1 && ( Fragment == 1 || SequentialID < 0 ) ) SequentialID = SequentialIDs.Get(Channel);
+
+  const char *FragmentPayload = GetFragmentPayload(Fragment, FillBits);
+  if ( FragmentPayload == nullptr ) return false;
+
+  if ( !Init("VDM", "AI", '!') ) return false;
+  Field[0] = '0' + Count;
+  if ( !AddStrField(Field) ) return false;
+  Field[0] = '0' + Fragment;
+  if ( !AddStrField(Field) ) return false;
+  if ( Count > 1 ) {
+    Field[0] = '0' + SequentialID;
+    if ( !AddStrField(Field) ) return false;
+  } else {
+    if ( !AddEmptyField() ) return false;
+  }
+  Field[0] = Channel;
+  if ( !AddStrField(Field) ) return false;
+  if ( !AddStrField(FragmentPayload) ) return false;
+  Field[0] = '0' + FillBits;
+  if ( !AddStrField(Field) ) return false;
+
+  return true;
+}
+
+//******************************************************************************
+bool tNMEA0183AISMsg::BuildFragment(uint8_t Fragment, char Channel) {
+  return BuildFragment(Fragment, Channel, *SequentialIDs);
+}
+
+//******************************************************************************
+size_t tNMEA0183AISMsg::GetSentences(char *Buf, size_t BufSize, char Channel, tAISSequentialIDs &SequentialIDs) const {
+  if ( GetFragmentCount() > 1 ) SequentialID = SequentialIDs.Get(Channel);
+  return AISWriteSentences(Buf, BufSize, PayloadBits, iAddPldBin, Channel, (uint8_t)SequentialID);
+}
+
+//******************************************************************************
+size_t tNMEA0183AISMsg::GetSentences(char *Buf, size_t BufSize, char Channel) const {
+  return GetSentences(Buf, BufSize, Channel, *SequentialIDs);
+}
+
+//*************************  DIRECT SENTENCE OUTPUT  ***************************
+static const char HexChars[] = "0123456789ABCDEF";
+
+size_t AISWriteSentences(char *Buf, size_t BufSize, const uint8_t *Bits, uint16_t Length,
+                         char Channel, tAISSequentialIDs &SequentialIDs) {
+  uint16_t nChars = ( Length + 5 ) / 6;
+  uint8_t Count = ( nChars + AIS_MAX_FRAGMENT_LEN - 1 ) / AIS_MAX_FRAGMENT_LEN;
+  if ( Count == 0 || Count > 9 ) return 0;
+
+  return AISWriteSentences(Buf, BufSize, Bits, Length, Channel, ( Count > 1 ? SequentialIDs.Get(Channel) : 0 ));
+}
+
+//******************************************************************************
+size_t AISWriteSentences(char *Buf, size_t BufSize, const uint8_t *Bits, uint16_t Length, char Channel, uint8_t SequentialID) {
+  uint16_t nChars = ( Length + 5 ) / 6;
+  uint8_t Count = ( nChars + AIS_MAX_FRAGMENT_LEN - 1 ) / AIS_MAX_FRAGMENT_LEN;
+  if ( Count == 0 || Count > 9 || SequentialID > 9 ) return 0;
+
+  size_t iBuf = 0;
+
+  for (uint8_t Fragment = 1; Fragment <= Count; Fragment++) {
+    uint16_t Start = ( Fragment - 1 ) * AIS_MAX_FRAGMENT_LEN * 6;
+    uint16_t FragmentLength = Length - Start;
+    if ( FragmentLength > AIS_MAX_FRAGMENT_LEN * 6 ) FragmentLength = AIS_MAX_FRAGMENT_LEN * 6;
+    uint16_t FragmentChars = ( FragmentLength + 5 ) / 6;
+    // !AIVDM,n,n,s,c,<payload>,f*hh\r\n + terminating 0
+    if ( iBuf + 23 + FragmentChars > BufSize ) return 0;
+
+    char *p = Buf + iBuf;
+    char *Sentence = p;
+    memcpy(p, "!AIVDM,", 7); p += 7;
+    *p++ = '0' + Count; *p++ = ',';
+    *p++ = '0' + Fragment; *p++ = ',';
+    if ( Count > 1 ) *p++ = '0' + SequentialID;
+    *p++ = ','; *p++ = Channel; *p++ = ',';
+    p += AISArmorBits(p, Bits, Start, FragmentLength);
+    *p++ = ',';
+    *p++ = '0' + ( 6 - FragmentLength % 6 ) % 6;
+
+    uint8_t CheckSum = 0;
+    for (const char *c = Sentence + 1; c < p; c++) CheckSum ^= *c;
+    *p++ = '*';
+    *p++ = HexChars[CheckSum >> 4];
+    *p++ = HexChars[CheckSum & 0x0f];
+    *p++ = '\r'; *p++ = '\n';
+    iBuf = p - Buf;
+  }
+  Buf[iBuf] = 0;
+
+  return iBuf;
+}
+
+//******************************************************************************
+size_t AISWriteSentences(char *Buf, size_t BufSize, const uint8_t *Bits, uint16_t Length, char Channel) {
+  return AISWriteSentences(Buf, BufSize, Bits, Length, Channel, DefaultSequentialIDs);
+}
+
 //**********************  BUILD 2-parted AIS Sentences  ************************
 const tNMEA0183AISMsg&  tNMEA0183AISMsg::BuildMsg5Part1(tNMEA0183AISMsg &AISMsg) {
 
-  Init("VDM", "AI", '!');
-  AddStrField("2");
-  AddStrField("1");
-  AddStrField("5");
-  AddStrField("A");
-  AddStrField( GetPayloadType5_Part1() );
-  AddStrField("0");
+  BuildFragment(1, 'A');
 
   return AISMsg;
 }
 
 const tNMEA0183AISMsg&  tNMEA0183AISMsg::BuildMsg5Part2(tNMEA0183AISMsg &AISMsg) {
 
-  Init("VDM", "AI", '!');
-  AddStrField("2");
-  AddStrField("2");
-  AddStrField("5");
-  AddStrField("A");
-  AddStrField( GetPayloadType5_Part2() );
-  AddStrField("2"); // Message 5, Part 2 has always 2 Padding Zeros
+  BuildFragment(2, 'A');
 
   return AISMsg;
 }
@@ -218,79 +345,61 @@ const tNMEA0183AISMsg& tNMEA0183AISMsg::BuildMsg24PartB(tNMEA0183AISMsg &AISMsg)
 // get converted Payload for Message 1, 2, 3 & 18, always Length 168
 const char *tNMEA0183AISMsg::GetPayload() {
 
-  uint16_t lenbin = strlen( PayloadBin);
-  if ( lenbin != 168 ) return nullptr;
+  if ( iAddPldBin != 168 ) return nullptr;
 
-  if ( !ConvertBinaryAISPayloadBinToAscii( PayloadBin ) ) return nullptr;
+  if ( !ConvertBinaryAISPayloadToAscii( PayloadBits, 0, 168 ) ) return nullptr;
   return Payload;
 }
 
 //******************************************************************************
 // get converted Part 1 of Payload for Message 5
 const char *tNMEA0183AISMsg::GetPayloadType5_Part1() {
+  uint8_t FillBits;
 
-  uint16_t lenbin = strlen( PayloadBin);
-  if ( lenbin != 424 ) return nullptr;
-
-  char to[337];
-  strncpy(to, PayloadBin, 336); // First Part is always 336 Length
-  to[336]=0;
+  if ( iAddPldBin != 424 ) return nullptr;
 
-  if ( !ConvertBinaryAISPayloadBinToAscii( to ) ) return nullptr;
-
-  return Payload;
+  return GetFragmentPayload(1, FillBits);
 }
 
 //******************************************************************************
 // get converted Part 2 of Payload for Message 5
 const char *tNMEA0183AISMsg::GetPayloadType5_Part2() {
+  uint8_t FillBits;
 
-  uint16_t lenbin = strlen( PayloadBin);
-  if ( lenbin != 424 ) return nullptr;
+  if ( iAddPldBin != 424 ) return nullptr;
 
-  lenbin = 88;        // Second Part is always 424 - 336 + 2 padding Zeros in Length
-  char to[91];
-  strncpy(to, PayloadBin + 336, lenbin);
-  to[88]='0'; to[89]='0'; to[90]=0;
-
-  if ( !ConvertBinaryAISPayloadBinToAscii( to ) ) return nullptr;
-  return Payload;
+  return GetFragmentPayload(2, FillBits);
 }
 
 //******************************************************************************
 // get converted Part A of Payload for Message 24
 // Bit 0.....167, len 168
-// In PayloadBin is Part A and Part B chained together with Length 296
+// In PayloadBits is Part A and Part B chained together with Length 336 (SetAISClassBMessage24)
+// or Part A alone with Length 168 (SetAISClassBMessage24PartA)
 const char *tNMEA0183AISMsg::GetPayloadType24_PartA() {
-  uint16_t lenbin = strlen( PayloadBin);
-  if ( lenbin != 296 ) return nullptr;    // too short for Part A
+  // Part Number is at bit 38, 2 bits
+  if ( iAddPldBin != 336 && ( iAddPldBin != 168 || AISGetBits(PayloadBits, 38, 2) != 0 ) ) return nullptr;
 
-  char to[169];    // Part A has Length 168
-  for (int i=0; i<168; i++){
-    to[i] = PayloadBin[i];
-  }
-  to[168]=0;
-  if ( !ConvertBinaryAISPayloadBinToAscii( to ) ) return nullptr;
+  // Part A has Length 168
+  if ( !ConvertBinaryAISPayloadToAscii( PayloadBits, 0, 168 ) ) return nullptr;
   return Payload;
 
 }
 
 //******************************************************************************
 // get converted Part B of Payload for Message 24
-// Bit 0.....38 + bit39='1' (part number) + bit 168........295  296='\0' of total PayloadBin
-// binary part B: len 40 + 128 = len 168
+// Bit 168........335 of total PayloadBits or Part B alone (SetAISClassBMessage24PartB), len 168
 const char *tNMEA0183AISMsg::GetPayloadType24_PartB() {
-  uint16_t lenbin = strlen( PayloadBin);
-  if ( lenbin != 296 ) return nullptr;    // too short for Part B
-  char to[169];    // Part B has Length 168
-  for (int i=0; i<39; i++){
-    to[i] = PayloadBin[i];
+  uint16_t Start;
+
+  if ( iAddPldBin == 336 ) {
+    Start = 168;
+  } else if ( iAddPldBin == 168 && AISGetBits(PayloadBits, 38, 2) == 1 ) {
+    Start = 0;
+  } else {
+    return nullptr;
   }
-  to[39] = 49;  // part number 1
-  for (int i=40; i<168; i++) {
-    to[i] = PayloadBin[i+128];
-  }
-  to[168]=0;
-  if ( !ConvertBinaryAISPayloadBinToAscii( to ) ) return nullptr;
+
+  if ( !ConvertBinaryAISPayloadToAscii( PayloadBits, Start, 168 ) ) return nullptr;
   return Payload;
 }
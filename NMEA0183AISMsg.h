@@ -29,38 +29,75 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <NMEA0183Msg.h>
 #include <string.h>
 #include <time.h>
-#include <bitset>
 #include <stdint.h>
 #include <math.h>
 #include <string>
+#include <atomic>
+#include "NMEA0183AISBits.h"
 
 
+#ifndef AIS_MAX_FRAGMENT_LEN
+#define AIS_MAX_FRAGMENT_LEN 60  // maximum payload characters in one sentence, keeps !AIVDM within 82 characters
+#endif
+
 #ifndef AIS_MSG_MAX_LEN
-#define AIS_MSG_MAX_LEN 100  // maximum length of AIS Payload
+#define AIS_MSG_MAX_LEN (AIS_MAX_FRAGMENT_LEN+1)  // maximum length of armored AIS Payload of one sentence incl. 0
 #endif
 
 #ifndef AIS_BIN_MAX_LEN
-#define AIS_BIN_MAX_LEN 500  // maximum length of AIS Binary Payload (before encoding to Ascii)
+#define AIS_BIN_MAX_LEN 424  // maximum length of AIS Binary Payload in bits, Message 5 is the longest one
 #endif
 
-#define BITSET_LENGTH 120
+// Size of buffer for AISWriteSentences() of a Length bits payload, including terminating 0.
+// E.g. char Buf[AISSentencesBufSize(tAISMessage5Layout::Length)];
+constexpr size_t AISSentencesBufSize(uint16_t Length) {
+  return ( Length <= AIS_MAX_FRAGMENT_LEN * 6
+           ? 22 + ( Length + 5 ) / 6 + 1
+           : 22 + AIS_MAX_FRAGMENT_LEN + AISSentencesBufSize(Length - AIS_MAX_FRAGMENT_LEN * 6) );
+}
+
+//*****************************************************************************
+// Rotating sequential message ID 0...9 for multi sentence messages, one counter per channel
+class tAISSequentialIDs {
+  protected:
+    std::atomic<uint8_t> NextID[2];   // Channel A, B
 
+  public:
+    tAISSequentialIDs() { NextID[0]=0; NextID[1]=0; }
+    uint8_t Get(char Channel);
+};
+
+//*****************************************************************************
+// Write Length bits of packed payload Bits as complete "!AIVDM,...*hh\r\n" sentences
+// to Buf without any intermediate copy. Multi sentence messages get sequential ID from
+// SequentialIDs. Buf will be 0 terminated.
+// Returns total length written without terminating 0 or 0, if Buf is too small.
+size_t AISWriteSentences(char *Buf, size_t BufSize, const uint8_t *Bits, uint16_t Length,
+                         char Channel, tAISSequentialIDs &SequentialIDs);
+size_t AISWriteSentences(char *Buf, size_t BufSize, const uint8_t *Bits, uint16_t Length, char Channel='A');
+// Same with given SequentialID 0...9 for multi sentence messages, e.g. the one of a copy already sent
+size_t AISWriteSentences(char *Buf, size_t BufSize, const uint8_t *Bits, uint16_t Length, char Channel, uint8_t SequentialID);
+
+//*****************************************************************************
 class tNMEA0183AISMsg : public tNMEA0183Msg {
 
   protected:  // AIS-NMEA
-    std::bitset<BITSET_LENGTH> bset;
     static const char *EmptyAISField;  // 6bits 0      not used yet.....
     static const char *AsciChar;
 
-    uint16_t iAddPldBin;
+    uint8_t PayloadBits[AIS_BITS_TO_BYTES(AIS_BIN_MAX_LEN)];  // packed binary payload, MSB first
+    uint16_t iAddPldBin;    // number of bits used in PayloadBits
     char Payload[AIS_MSG_MAX_LEN];
     uint8_t  iAddPld;
+    mutable int8_t SequentialID;  // of current multi sentence message, -1 = not assigned
+    tAISSequentialIDs *SequentialIDs;  // used, if not given explicitly
 
   public:
-    char PayloadBin[AIS_BIN_MAX_LEN];
-    char PayloadBin2[AIS_BIN_MAX_LEN];
     // Clear message
     void ClearAIS();
+    // Clear message and reserve Length bits for layout based encoders.
+    // Returns cleared packed payload or nullptr, if Length does not fit.
+    uint8_t *InitPayload(uint16_t Length);
 
   public:
     tNMEA0183AISMsg();
@@ -69,19 +106,43 @@ class tNMEA0183AISMsg : public tNMEA0183Msg {
     const char *GetPayloadType5_Part2();
     const char *GetPayloadType24_PartA();
     const char *GetPayloadType24_PartB();
-    const char *GetPayloadBin() const { return  PayloadBin; }
+    // Debug helper: '0'/'1' representation of the payload, Buf needs GetPayloadBitCount()+1 characters.
+    // Returns Buf or nullptr, if it is too small.
+    const char *GetPayloadBin(char *Buf, size_t BufSize) const;
+    const uint8_t *GetPayloadBits() const { return PayloadBits; }
+    uint16_t GetPayloadBitCount() const { return iAddPldBin; }
 
     const tNMEA0183AISMsg& BuildMsg5Part1(tNMEA0183AISMsg &AISMsgn);
     const tNMEA0183AISMsg& BuildMsg5Part2(tNMEA0183AISMsg &AISMsg);
     const tNMEA0183AISMsg& BuildMsg24PartA(tNMEA0183AISMsg &AISMsg);
     const tNMEA0183AISMsg& BuildMsg24PartB(tNMEA0183AISMsg &AISMsg);
 
+    // Use own sequential message IDs instead of the library default ones, e.g. those of tAISEncoderContext
+    void SetSequentialIDs(tAISSequentialIDs &_SequentialIDs) { SequentialIDs=&_SequentialIDs; }
+    tAISSequentialIDs &GetSequentialIDs() const { return *SequentialIDs; }
+    // Sequential message ID used by the last BuildFragment(1) or GetSentences() of a multi sentence message, -1 if none
+    int8_t GetSequentialID() const { return SequentialID; }
+
+    // Multi sentence output of any payload length. Fragment is 1...GetFragmentCount().
+    // Building fragment 1 of a multi sentence message assigns a new sequential message ID
+    // for Channel from SequentialIDs, following fragments use the same ID.
+    uint8_t GetFragmentCount() const;
+    const char *GetFragmentPayload(uint8_t Fragment, uint8_t &FillBits);
+    bool BuildFragment(uint8_t Fragment, char Channel, tAISSequentialIDs &SequentialIDs);
+    bool BuildFragment(uint8_t Fragment, char Channel='A');
+
+    // Write all sentences of current payload as complete "!AIVDM,...*hh\r\n" lines to Buf.
+    // Returns length written or 0, if Buf is too small.
+    size_t GetSentences(char *Buf, size_t BufSize, char Channel, tAISSequentialIDs &SequentialIDs) const;
+    size_t GetSentences(char *Buf, size_t BufSize, char Channel='A') const;
+
     // Generally Used
     bool AddIntToPayloadBin(int32_t ival, uint16_t countBits);
     bool AddBoolToPayloadBin(bool &bval, uint8_t size);
-    bool AddEncodedCharToPayloadBin(char *sval, size_t Length);
+    bool AddEncodedCharToPayloadBin(const char *sval, size_t Length);
     bool AddEmptyFieldToPayloadBin(uint8_t iBits);
     bool ConvertBinaryAISPayloadBinToAscii(const char *payloadbin);
+    bool ConvertBinaryAISPayloadToAscii(const uint8_t *Bits, uint16_t Start, uint16_t Length);
 
   // AIS Helper functions
   protected:
@@ -0,0 +1,150 @@
+/*
+NMEA0183AISOutputQueue.cpp
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "NMEA0183AISOutputQueue.h"
+#include <string.h>
+
+//*****************************************************************************
+tAISOutputQueue::tAISOutputQueue() : DropPolicy(DropLowestPriority), Limit((size_t)-1) {
+  Clear();
+}
+
+//*****************************************************************************
+void tAISOutputQueue::Clear() {
+  for (uint8_t i=0; i<Priorities; i++) {
+    tRing &Ring=Rings[i];
+    Ring.Head=0;
+    Ring.Tail=0;
+    Ring.End=AIS_OUTPUT_QUEUE_SIZE;
+    Ring.Count=0;
+    Ring.Pushed=0;
+    Ring.Sent=0;
+    Ring.Dropped=0;
+    Ring.Rejected=0;
+  }
+  Queued=0;
+}
+
+//*****************************************************************************
+// Position for Size bytes in Ring, if there is room
+bool tAISOutputQueue::Fits(const tRing &Ring, size_t Size, uint16_t &Pos) const {
+  if ( Ring.Count==0 ) { Pos=0; return Size<=AIS_OUTPUT_QUEUE_SIZE; }
+
+  if ( Ring.Tail>Ring.Head ) {          // entries in Head ... Tail
+    if ( (size_t)(AIS_OUTPUT_QUEUE_SIZE-Ring.Tail)>=Size ) { Pos=Ring.Tail; return true; }
+    Pos=0;
+    return Ring.Head>=Size;
+  }
+
+  // entries in Head ... End and 0 ... Tail
+  Pos=Ring.Tail;
+  return (size_t)(Ring.Head-Ring.Tail)>=Size;
+}
+
+//*****************************************************************************
+void tAISOutputQueue::RemoveFront(tRing &Ring) {
+  tHeader Header;
+  memcpy(&Header, Ring.Buf+Ring.Head, sizeof(Header));
+  Queued-=EntrySize(Header.Len);
+  Ring.Count--;
+  if ( Ring.Count==0 ) {
+    Ring.Head=0;
+    Ring.Tail=0;
+    Ring.End=AIS_OUTPUT_QUEUE_SIZE;
+    return;
+  }
+  Ring.Head+=EntrySize(Header.Len);
+  if ( Ring.Head>=Ring.End ) {
+    Ring.Head=0;
+    Ring.End=AIS_OUTPUT_QUEUE_SIZE;
+  }
+}
+
+//*****************************************************************************
+void tAISOutputQueue::DropFront(uint8_t Priority) {
+  RemoveFront(Rings[Priority]);
+  Rings[Priority].Dropped++;
+}
+
+//*****************************************************************************
+bool tAISOutputQueue::Push(tPriority Priority, const char *Text, size_t Len, uint32_t Sinks) {
+  tRing &Ring=Rings[Priority];
+  size_t Size=EntrySize(Len);
+
+  if ( Len==0 || Size>AIS_OUTPUT_QUEUE_SIZE || Size>Limit ) { Ring.Rejected++; return false; }
+
+  if ( DropPolicy==DropLowestPriority ) {
+    for (uint8_t Lower=Priorities-1; Lower>Priority && Queued+Size>Limit; Lower--) {
+      while ( Rings[Lower].Count>0 && Queued+Size>Limit ) DropFront(Lower);
+    }
+  }
+  while ( Ring.Count>0 && Queued+Size>Limit ) DropFront(Priority);
+  if ( Queued+Size>Limit ) { Ring.Rejected++; return false; }  // higher priorities fill the limit
+
+  uint16_t Pos;
+  while ( !Fits(Ring, Size, Pos) ) DropFront(Priority);
+  if ( Pos==0 && Ring.Count>0 ) Ring.End=Ring.Tail;  // restart at 0
+
+  tHeader Header;
+  Header.Len=(uint16_t)Len;
+  Header.Sinks=Sinks;
+  memcpy(Ring.Buf+Pos, &Header, sizeof(Header));
+  memcpy(Ring.Buf+Pos+sizeof(Header), Text, Len);
+  Ring.Buf[Pos+sizeof(Header)+Len]=0;
+  Ring.Tail=Pos+Size;
+  Ring.Count++;
+  Ring.Pushed++;
+  Queued+=Size;
+  return true;
+}
+
+//*****************************************************************************
+bool tAISOutputQueue::Push(tPriority Priority, const char *Text, uint32_t Sinks) {
+  return Push(Priority, Text, ( Text!=0 ? strlen(Text) : 0 ), Sinks);
+}
+
+//*****************************************************************************
+size_t tAISOutputQueue::Front(const char *&Text, uint32_t &Sinks) const {
+  for (uint8_t i=0; i<Priorities; i++) {
+    const tRing &Ring=Rings[i];
+    if ( Ring.Count==0 ) continue;
+    tHeader Header;
+    memcpy(&Header, Ring.Buf+Ring.Head, sizeof(Header));
+    Text=Ring.Buf+Ring.Head+sizeof(Header);
+    Sinks=Header.Sinks;
+    return Header.Len;
+  }
+  return 0;
+}
+
+//*****************************************************************************
+void tAISOutputQueue::Pop() {
+  for (uint8_t i=0; i<Priorities; i++) {
+    tRing &Ring=Rings[i];
+    if ( Ring.Count==0 ) continue;
+    RemoveFront(Ring);
+    Ring.Sent++;
+    return;
+  }
+}
@@ -0,0 +1,115 @@
+/*
+NMEA0183AISOutputQueue.h
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+// Output stage between conversion and slow outputs. Complete "...\r\n" lines are queued
+// in fixed size rings per priority and taken out highest priority first, as far as the
+// outputs can take them. So own ship data is not delayed or lost behind AIS bursts.
+
+#ifndef _tNMEA0183AISOutputQueue_H_
+#define _tNMEA0183AISOutputQueue_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef AIS_OUTPUT_QUEUE_SIZE
+#define AIS_OUTPUT_QUEUE_SIZE 1024  // bytes per priority
+#endif
+
+static_assert(AIS_OUTPUT_QUEUE_SIZE<=0xffff, "AIS_OUTPUT_QUEUE_SIZE must be below 64 kB");
+
+//*****************************************************************************
+class tAISOutputQueue {
+  public:
+    enum tPriority {
+      OwnShip=0,              // own ship navigation: RMC, HDG, VTG, ...
+      AISPosition=1,          // Message 1, 2, 3, 18
+      AISStatic=2             // Message 5, 24
+    };
+    static const uint8_t Priorities=3;
+
+    // On full rings or when the limit is reached:
+    enum tDropPolicy {
+      DropOldest,             // oldest entries of the same priority are dropped
+      DropLowestPriority      // oldest entries of the lowest priority below are dropped first, then DropOldest
+    };
+
+  protected:
+    // Entry: tHeader, text, 0. Entries do not wrap, the ring restarts at 0 if the end is too short.
+    struct tHeader {
+      uint16_t Len;             // of text
+      uint32_t Sinks;
+    };
+
+    struct tRing {
+      char Buf[AIS_OUTPUT_QUEUE_SIZE];
+      uint16_t Head;            // first entry
+      uint16_t Tail;            // next free byte
+      uint16_t End;             // end of entries before restart at 0
+      uint16_t Count;           // entries
+      uint32_t Pushed;
+      uint32_t Sent;
+      uint32_t Dropped;         // queued, dropped for newer or higher priority ones
+      uint32_t Rejected;        // not queued at all
+    };
+
+    tRing Rings[Priorities];
+    tDropPolicy DropPolicy;
+    size_t Limit;
+    size_t Queued;
+
+    static size_t EntrySize(size_t Len) { return sizeof(tHeader)+Len+1; }
+    bool Fits(const tRing &Ring, size_t Size, uint16_t &Pos) const;
+    void DropFront(uint8_t Priority);
+    void RemoveFront(tRing &Ring);
+
+  public:
+    tAISOutputQueue();
+    void Clear();
+
+    void SetDropPolicy(tDropPolicy _DropPolicy) { DropPolicy=_DropPolicy; }
+    // Bytes queued in all rings together, e.g. what the outputs can send in a second.
+    // Default is no limit beyond the ring sizes.
+    void SetLimit(size_t _Limit) { Limit=_Limit; }
+
+    // Queue Len characters of complete lines for the outputs with bit set in Sinks.
+    // Returns false, if it was rejected by the drop policy or is longer than a ring.
+    bool Push(tPriority Priority, const char *Text, size_t Len, uint32_t Sinks=0xffffffff);
+    bool Push(tPriority Priority, const char *Text, uint32_t Sinks=0xffffffff);
+
+    // Next entry, highest priority first. Returns its length or 0 if queue is empty.
+    // Text is 0 terminated and valid until Pop() or Push().
+    size_t Front(const char *&Text, uint32_t &Sinks) const;
+    // Remove entry returned by Front()
+    void Pop();
+
+    bool IsEmpty() const { return Queued==0; }
+    size_t GetQueuedBytes() const { return Queued; }
+    uint16_t GetCount(tPriority Priority) const { return Rings[Priority].Count; }
+    uint32_t GetPushedCount(tPriority Priority) const { return Rings[Priority].Pushed; }
+    uint32_t GetSentCount(tPriority Priority) const { return Rings[Priority].Sent; }
+    uint32_t GetDroppedCount(tPriority Priority) const { return Rings[Priority].Dropped; }
+    uint32_t GetRejectedCount(tPriority Priority) const { return Rings[Priority].Rejected; }
+};
+
+#endif
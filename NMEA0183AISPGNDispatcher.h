@@ -0,0 +1,90 @@
+/*
+NMEA0183AISPGNDispatcher.h
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+// Dispatch of N2k messages by PGN to member functions of a message handler class, e.g. derived
+// from tNMEA2000::tMsgHandler. The handlers are given as table sorted by PGN and found by binary
+// search, a bit mask of PGN%64 rejects most other PGNs at once. The order is checked once in the
+// constructor; a table, which is not sorted, is searched linearly, so all handlers are still found.
+
+#ifndef _tNMEA0183AISPGNDispatcher_H_
+#define _tNMEA0183AISPGNDispatcher_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <N2kMsg.h>
+
+//*****************************************************************************
+template <class tHandlerClass>
+class tAISPGNDispatcher {
+  public:
+    typedef void (tHandlerClass::*tHandler)(const tN2kMsg &N2kMsg);
+    struct tEntry {
+      unsigned long PGN;
+      tHandler Handler;
+    };
+
+  protected:
+    const tEntry *Entries;
+    size_t Count;
+    uint64_t Mask;  // bit PGN%64 set for handled PGNs
+    bool Sorted;
+
+    static uint64_t PGNBit(unsigned long PGN) { return (uint64_t)1<<(PGN & 63); }
+
+    const tEntry *Find(unsigned long PGN) const {
+      if ( !Sorted ) {
+        for (size_t i=0; i<Count; i++) if ( Entries[i].PGN==PGN ) return &Entries[i];
+        return 0;
+      }
+      size_t First=0, Last=Count;
+      while ( First<Last ) {
+        size_t Middle=(First+Last)/2;
+        if ( Entries[Middle].PGN<PGN ) First=Middle+1; else Last=Middle;
+      }
+      return ( First<Count && Entries[First].PGN==PGN ? &Entries[First] : 0 );
+    }
+
+  public:
+    // _Entries must stay valid, e.g. a static const table
+    tAISPGNDispatcher(const tEntry *_Entries, size_t _Count) : Entries(_Entries), Count(_Count), Mask(0), Sorted(true) {
+      for (size_t i=0; i<Count; i++) {
+        Mask|=PGNBit(Entries[i].PGN);
+        if ( i>0 && Entries[i-1].PGN>=Entries[i].PGN ) Sorted=false;
+      }
+    }
+
+    // false, if PGNs are not in ascending order or one is twice in the table
+    bool IsSorted() const { return Sorted; }
+
+    // Call the handler of N2kMsg.PGN on Object. Returns false, if the PGN has no handler.
+    bool Dispatch(tHandlerClass &Object, const tN2kMsg &N2kMsg) const {
+      if ( (Mask & PGNBit(N2kMsg.PGN))==0 ) return false;
+      const tEntry *Entry=Find(N2kMsg.PGN);
+      if ( Entry==0 ) return false;
+      (Object.*Entry->Handler)(N2kMsg);
+      return true;
+    }
+};
+
+#endif
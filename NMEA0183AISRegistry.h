@@ -0,0 +1,241 @@
+/*
+NMEA0183AISRegistry.h
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+// Fixed size maps MMSI -> slot / Value without heap use.
+// Open addressing with linear probing and backward shift deletion. Entries are kept
+// in a list by age of last insert, so the oldest entry is replaced in O(1), when
+// the map is full.
+// MMSI 0 is not available and can not be stored.
+
+#ifndef _tNMEA0183AISRegistry_H_
+#define _tNMEA0183AISRegistry_H_
+
+#include <stdint.h>
+#include <string.h>
+
+// Default sizes of the fixed size tables by RAM of the board: AVR (8 kB), Arduino DUE and
+// Teensy 3.2 (64...96 kB) and all others. Each table size can be set with its own define.
+#if defined(__AVR__)
+#define AIS_TABLE_SIZE(Small, Medium, Large) (Small)
+#elif defined(__SAM3X8E__) || defined(__MK20DX256__)
+#define AIS_TABLE_SIZE(Small, Medium, Large) (Medium)
+#else
+#define AIS_TABLE_SIZE(Small, Medium, Large) (Large)
+#endif
+
+// Smallest power of 2 >= 2*n, keeps load factor of index table <= 0.5
+constexpr uint32_t AISMapTableSize(uint32_t n, uint32_t s=1) { return s>=2*n ? s : AISMapTableSize(n, s*2); }
+
+//*****************************************************************************
+// MMSI -> slot 0..._Capacity-1. Slots can be used as index to own arrays.
+template <uint16_t _Capacity>
+class tAISMMSIIndex {
+  public:
+    static constexpr uint16_t Capacity=_Capacity;
+    static constexpr uint16_t TableSize=AISMapTableSize(_Capacity);
+    static constexpr uint16_t None=0xffff;
+
+  protected:
+    static_assert(_Capacity>0 && _Capacity<=16384, "AIS map capacity out of range");
+
+    struct tIndex {
+      uint32_t UserID;          // 0 = empty
+      uint16_t Slot;
+    };
+
+    tIndex Index[TableSize];
+    uint32_t UserIDs[_Capacity];
+    uint16_t Older[_Capacity];  // age list
+    uint16_t Newer[_Capacity];  // age list, free list for unused slots
+    uint16_t Oldest;
+    uint16_t Newest;
+    uint16_t Free;
+    uint16_t Count;
+
+    static inline uint16_t Hash(uint32_t UserID) { return (uint16_t)((UserID*2654435761u)>>16) & (TableSize-1); }
+
+    uint16_t FindIndex(uint32_t UserID) const {
+      for (uint16_t i=Hash(UserID); Index[i].UserID!=0; i=(i+1) & (TableSize-1)) {
+        if ( Index[i].UserID==UserID ) return i;
+      }
+      return None;
+    }
+
+    // Remove Index[i] and move following entries of the probe sequence back
+    void RemoveIndex(uint16_t i) {
+      uint16_t j=i;
+      for (;;) {
+        j=(j+1) & (TableSize-1);
+        if ( Index[j].UserID==0 ) break;
+        uint16_t k=Hash(Index[j].UserID);
+        if ( i<=j ? (i<k && k<=j) : (i<k || k<=j) ) continue;  // entry is still reachable
+        Index[i]=Index[j];
+        i=j;
+      }
+      Index[i].UserID=0;
+    }
+
+    void Unlink(uint16_t Slot) {
+      if ( Older[Slot]!=None ) Newer[Older[Slot]]=Newer[Slot]; else Oldest=Newer[Slot];
+      if ( Newer[Slot]!=None ) Older[Newer[Slot]]=Older[Slot]; else Newest=Older[Slot];
+    }
+
+    void LinkNewest(uint16_t Slot) {
+      Older[Slot]=Newest;
+      Newer[Slot]=None;
+      if ( Newest!=None ) Newer[Newest]=Slot; else Oldest=Slot;
+      Newest=Slot;
+    }
+
+  public:
+    tAISMMSIIndex() { Clear(); }
+
+    void Clear() {
+      for (uint16_t i=0; i<TableSize; i++) Index[i].UserID=0;
+      for (uint16_t i=0; i<_Capacity; i++) {
+        UserIDs[i]=0;
+        Newer[i]=( i+1<_Capacity ? i+1 : None );
+      }
+      Free=0;
+      Oldest=Newest=None;
+      Count=0;
+    }
+
+    uint16_t Size() const { return Count; }
+
+    // Slot of UserID or None
+    uint16_t Find(uint32_t UserID) const {
+      if ( UserID==0 ) return None;
+      uint16_t i=FindIndex(UserID);
+      return ( i==None ? None : Index[i].Slot );
+    }
+
+    // Find or add slot for UserID and make it the newest one. The oldest
+    // slot is reused, if index is full. Returns None for UserID 0.
+    uint16_t Insert(uint32_t UserID, bool *Added=0) {
+      if ( Added ) *Added=false;
+      if ( UserID==0 ) return None;
+
+      uint16_t i=FindIndex(UserID);
+      if ( i!=None ) {
+        uint16_t Slot=Index[i].Slot;
+        Unlink(Slot);
+        LinkNewest(Slot);
+        return Slot;
+      }
+
+      uint16_t Slot;
+      if ( Free!=None ) {
+        Slot=Free;
+        Free=Newer[Slot];
+        Count++;
+      } else {
+        Slot=Oldest;
+        Unlink(Slot);
+        RemoveIndex(FindIndex(UserIDs[Slot]));
+      }
+      LinkNewest(Slot);
+      UserIDs[Slot]=UserID;
+
+      for (i=Hash(UserID); Index[i].UserID!=0; i=(i+1) & (TableSize-1));
+      Index[i].UserID=UserID;
+      Index[i].Slot=Slot;
+
+      if ( Added ) *Added=true;
+      return Slot;
+    }
+
+    bool Remove(uint32_t UserID) {
+      if ( UserID==0 ) return false;
+      uint16_t i=FindIndex(UserID);
+      if ( i==None ) return false;
+      uint16_t Slot=Index[i].Slot;
+      RemoveIndex(i);
+      Unlink(Slot);
+      UserIDs[Slot]=0;
+      Newer[Slot]=Free;
+      Free=Slot;
+      Count--;
+      return true;
+    }
+
+    // Iterate used slots from oldest to newest: for (s=GetOldest(); s!=None; s=GetNewer(s))
+    uint16_t GetOldest() const { return Oldest; }
+    uint16_t GetNewer(uint16_t Slot) const { return Newer[Slot]; }
+    uint32_t GetUserID(uint16_t Slot) const { return UserIDs[Slot]; }
+    // Slots 0...Capacity-1 keep their place, when entries are updated. Use this for
+    // iterations, which may be interrupted by inserts.
+    bool IsUsed(uint16_t Slot) const { return UserIDs[Slot]!=0; }
+};
+
+//*****************************************************************************
+// MMSI -> Value
+template <class tValue, uint16_t _Capacity>
+class tAISMMSIMap : public tAISMMSIIndex<_Capacity> {
+  protected:
+    typedef tAISMMSIIndex<_Capacity> tBase;
+    tValue Values[_Capacity];
+
+  public:
+    tValue *Find(uint32_t UserID) {
+      uint16_t Slot=tBase::Find(UserID);
+      return ( Slot==tBase::None ? 0 : &Values[Slot] );
+    }
+
+    const tValue *Find(uint32_t UserID) const {
+      return const_cast<tAISMMSIMap *>(this)->Find(UserID);
+    }
+
+    // Find or add entry for UserID and make it the newest one. New entries are
+    // value initialized, the oldest entry is replaced, if map is full.
+    // Returns nullptr for UserID 0.
+    tValue *Insert(uint32_t UserID, bool *Added=0) {
+      bool New;
+      uint16_t Slot=tBase::Insert(UserID, &New);
+      if ( Added ) *Added=New;
+      if ( Slot==tBase::None ) return 0;
+      if ( New ) Values[Slot]=tValue();
+      return &Values[Slot];
+    }
+
+    tValue &GetValue(uint16_t Slot) { return Values[Slot]; }
+    const tValue &GetValue(uint16_t Slot) const { return Values[Slot]; }
+};
+
+//*****************************************************************************
+// Ship name of Message 24 Part A, 20 characters
+struct tAISShipName {
+  char Name[21];
+
+  tAISShipName() { Name[0]=0; }
+  void Set(const char *_Name) { strncpy(Name, _Name, sizeof(Name)-1); Name[sizeof(Name)-1]=0; }
+};
+
+#ifndef AIS_SHIP_REGISTRY_SIZE
+#define AIS_SHIP_REGISTRY_SIZE AIS_TABLE_SIZE(16,64,256)  // Class B ship names remembered, oldest is replaced. 45 bytes per name
+#endif
+
+typedef tAISMMSIMap<tAISShipName, AIS_SHIP_REGISTRY_SIZE> tAISShipRegistry;
+
+#endif
@@ -0,0 +1,247 @@
+/*
+NMEA0183AISSentenceCache.cpp
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "NMEA0183AISSentenceCache.h"
+#include "NMEA0183AISLayout.h"
+#include <string.h>
+
+static const char HexChars[] = "0123456789ABCDEF";
+
+//*****************************************************************************
+tAISStaticKey &tAISStaticKey::AddText(const char *Text, uint8_t Chars) {
+  if ( Len>sizeof(Data) || Len+Chars>sizeof(Data) ) { Len=0xff; return *this; }
+  uint8_t i=0;
+  if ( Text!=0 ) for (; i<Chars && Text[i]!=0; i++) Data[Len+i]=Text[i];
+  memset(Data+Len+i, 0, Chars-i);
+  Len+=Chars;
+  return *this;
+}
+
+//*****************************************************************************
+uint32_t tAISStaticKey::GetHash() const {
+  uint32_t Hash=2166136261UL;
+  if ( Len>sizeof(Data) ) return Hash;
+  uint8_t i=0;
+  for (; i+4<=Len; i+=4) {
+    uint32_t Word;
+    memcpy(&Word, Data+i, sizeof(Word));
+    Hash=(Hash^Word)*16777619UL;
+  }
+  for (; i<Len; i++) Hash=(Hash^Data[i])*16777619UL;
+  return Hash;
+}
+
+//*****************************************************************************
+// Hash first, the stored copy decides on equal hashes
+bool tAISStaticSentences::SameKey(bool PartB, const tAISStaticKey *Key) const {
+  if ( Key==0 ) return false;
+  uint8_t KeyLen=( PartB ? KeyLenB : KeyLenA );
+  if ( KeyLen==0 || KeyLen!=Key->GetLength() || ( PartB ? HashB : HashA )!=Key->GetHash() ) return false;
+  return memcmp(Keys+( PartB ? AIS_STATIC_KEY_PART_B : 0 ), Key->GetData(), KeyLen)==0;
+}
+
+//*****************************************************************************
+// Replace Part A (Message 5) or Part B, keeping the other part behind Part A
+bool tAISStaticSentences::SetPart(bool PartB, const char *Sentences, size_t Len, const tAISStaticKey *Key) {
+  uint8_t Pos=( PartB ? AIS_STATIC_KEY_PART_B : 0 );
+  uint8_t KeyLen=0;
+  // Message 5 key takes also the room of Part B key
+  if ( Key!=0 && Pos+Key->GetLength()<=( PartB || MessageType==5 ? AIS_STATIC_KEY_LEN : AIS_STATIC_KEY_PART_B ) ) {
+    KeyLen=Key->GetLength();
+  }
+
+  if ( PartB ) {
+    if ( LenA+Len>AIS_STATIC_SENTENCES_LEN ) return false;
+    memcpy(Text+LenA, Sentences, Len);
+    LenB=Len;
+    KeyLenB=KeyLen;
+  } else {
+    if ( Len+LenB>AIS_STATIC_SENTENCES_LEN ) return false;
+    memmove(Text+Len, Text+LenA, LenB);
+    memcpy(Text, Sentences, Len);
+    LenA=Len;
+    KeyLenA=KeyLen;
+  }
+  if ( KeyLen>0 ) {
+    memcpy(Keys+Pos, Key->GetData(), KeyLen);
+    ( PartB ? HashB : HashA )=Key->GetHash();
+  }
+  Text[LenA+LenB]=0;
+  return true;
+}
+
+//*****************************************************************************
+// Give each multi sentence message in Sentences a new sequential ID and patch the checksums
+static void NewSequentialIDs(char *Sentences, size_t Len, tAISSequentialIDs &SequentialIDs) {
+  char ID=0;
+
+  for (char *p=Sentences, *End=Sentences+Len; p<End; ) {
+    char *Line=p;
+    char *LineEnd=(char *)memchr(Line, '\n', End-Line);
+    p=( LineEnd!=0 ? LineEnd+1 : End );
+    // "!AIVDM,n,f,s,c,...*hh", s at 11 is empty for single sentences
+    if ( p-Line<17 || Line[11]<'0' || Line[11]>'9' || Line[12]!=',' ) continue;
+    if ( Line[9]=='1' ) ID='0'+SequentialIDs.Get(Line[13]);
+    if ( ID==0 ) continue;
+    char *Star=(char *)memchr(Line, '*', p-Line);
+    if ( Star==0 || p-Star<3 ) continue;
+    const char *h=strchr(HexChars, Star[1]), *l=strchr(HexChars, Star[2]);
+    if ( h==0 || l==0 ) continue;
+    uint8_t CheckSum=(((h-HexChars)<<4) | (l-HexChars)) ^ Line[11] ^ ID;
+    Line[11]=ID;
+    Star[1]=HexChars[CheckSum>>4];
+    Star[2]=HexChars[CheckSum & 0x0f];
+  }
+}
+
+//*****************************************************************************
+bool tAISStaticSentenceCache::SetSentences(uint32_t UserID, uint8_t MessageType, bool PartB, const char *Sentences, size_t Len, const tAISStaticKey *Key) {
+  if ( MessageType!=5 && MessageType!=24 ) return false;
+
+  tAISStaticSentences *Static=Map.Insert(UserID);
+  if ( Static==0 ) return false;
+  if ( Static->MessageType!=MessageType ) {
+    Static->MessageType=MessageType;
+    Static->LenA=0;
+    Static->LenB=0;
+    Static->KeyLenA=0;
+    Static->KeyLenB=0;
+    Static->Text[0]=0;
+  }
+
+  return Static->SetPart(PartB, Sentences, Len, Key);
+}
+
+//*****************************************************************************
+size_t tAISStaticSentenceCache::Get(uint32_t UserID, uint8_t MessageType, const tAISStaticKey &KeyA, const tAISStaticKey *KeyB,
+                                    char *Buf, size_t BufSize, tAISSequentialIDs &SequentialIDs) const {
+  const tAISStaticSentences *Static=Map.Find(UserID);
+  if ( Static==0 || Static->MessageType!=MessageType || !Static->SameKey(false, &KeyA) ) return 0;
+  if ( KeyB!=0 ? !Static->SameKey(true, KeyB) : Static->LenB!=0 ) return 0;
+
+  size_t Len=Static->GetLength();
+  if ( Len+1>BufSize ) return 0;
+  memcpy(Buf, Static->Text, Len+1);
+  NewSequentialIDs(Buf, Len, SequentialIDs);
+  return Len;
+}
+
+//*****************************************************************************
+size_t tAISStaticSentenceCache::GetPart(uint32_t UserID, uint8_t MessageType, bool PartB, const tAISStaticKey &Key,
+                                        char *Buf, size_t BufSize, tAISSequentialIDs &SequentialIDs) const {
+  const tAISStaticSentences *Static=Map.Find(UserID);
+  if ( Static==0 || Static->MessageType!=MessageType || !Static->SameKey(PartB, &Key) ) return 0;
+
+  size_t Len=( PartB ? Static->LenB : Static->LenA );
+  if ( Len==0 || Len+1>BufSize ) return 0;
+  memcpy(Buf, Static->Text+( PartB ? Static->LenA : 0 ), Len);
+  Buf[Len]=0;
+  NewSequentialIDs(Buf, Len, SequentialIDs);
+  return Len;
+}
+
+//*****************************************************************************
+bool tAISStaticSentenceCache::Set(const uint8_t *Bits, uint16_t Length, char Channel, uint8_t SequentialID) {
+  typedef tAISMessage24ALayout LA;
+  char Sentences[AIS_STATIC_SENTENCES_LEN+1];
+
+  if ( Length<LA::Length ) return false;
+  uint8_t MessageType=LA::Get<LA::MessageType>(Bits);
+  uint32_t UserID=LA::Get<LA::UserID>(Bits);
+
+  if ( MessageType==5 ) {
+    size_t Len=AISWriteSentences(Sentences, sizeof(Sentences), Bits, Length, Channel, SequentialID);
+    return ( Len>0 && SetSentences(UserID, MessageType, false, Sentences, Len) );
+  }
+  if ( MessageType!=24 ) return false;
+
+  // Message 24, one or both parts with 168 bits each
+  bool Result=true;
+  for (; Length>=LA::Length; Bits+=LA::Bytes, Length-=LA::Length) {
+    size_t Len=AISWriteSentences(Sentences, sizeof(Sentences), Bits, LA::Length, Channel);  // single sentence
+    Result&=( Len>0 && SetSentences(UserID, MessageType, LA::Get<LA::PartNumber>(Bits)==1, Sentences, Len) );
+  }
+  return Result;
+}
+
+//*****************************************************************************
+bool tAISStaticSentenceCache::Set(const tNMEA0183AISMsg &NMEA0183AISMsg, char Channel) {
+  int8_t SequentialID=NMEA0183AISMsg.GetSequentialID();
+  if ( SequentialID<0 ) SequentialID=NMEA0183AISMsg.GetSequentialIDs().Get(Channel);  // not sent yet
+  return Set(NMEA0183AISMsg.GetPayloadBits(), NMEA0183AISMsg.GetPayloadBitCount(), Channel, (uint8_t)SequentialID);
+}
+
+//*****************************************************************************
+size_t tAISPositionSentenceCache::Write(char *Buf, size_t BufSize, const uint8_t *Bits, uint16_t Length, char Channel) {
+  typedef tAISMessageLayout<AIS_POSITION_PAYLOAD_LEN> L;
+  const uint8_t nBytes=AIS_BITS_TO_BYTES(AIS_POSITION_PAYLOAD_LEN);
+
+  if ( Length!=AIS_POSITION_PAYLOAD_LEN ) return AISWriteSentences(Buf, BufSize, Bits, Length, Channel);
+
+  tAISPositionSentence *Sentence=Map.Insert(L::Get<L::UserID>(Bits));
+  if ( Sentence==0 ) return AISWriteSentences(Buf, BufSize, Bits, Length, Channel);
+
+  if ( Sentence->Len==0 || Sentence->Channel!=Channel ) {
+    // First report of target, write whole sentence
+    size_t Len=AISWriteSentences(Buf, BufSize, Bits, Length, Channel);
+    if ( Len!=AIS_POSITION_SENTENCE_LEN ) { Sentence->Len=0; return Len; }
+    memcpy(Sentence->Text, Buf, sizeof(Sentence->Text));
+    memcpy(Sentence->Bits, Bits, nBytes);
+    Sentence->Len=Len;
+    Sentence->Channel=Channel;
+    // Payload is followed by ",0*hh\r\n"
+    Sentence->PayloadPos=Len-7-(AIS_POSITION_PAYLOAD_LEN+5)/6;
+    Sentence->CheckSum=0;
+    for (uint8_t i=1; i<Len-5; i++) Sentence->CheckSum^=Sentence->Text[i];
+    return Len;
+  }
+
+  if ( BufSize<sizeof(Sentence->Text) ) return 0;
+
+  // Every 3 payload bytes are 4 characters. Armor only groups with changed bits again.
+  char *Payload=Sentence->Text+Sentence->PayloadPos;
+  uint8_t *Old=Sentence->Bits;
+  uint8_t CheckSum=0;
+  for (uint8_t i=0; i<nBytes; i+=3) {
+    uint32_t v=((uint32_t)Bits[i]<<16) | ((uint32_t)Bits[i+1]<<8) | Bits[i+2];
+    if ( v==(((uint32_t)Old[i]<<16) | ((uint32_t)Old[i+1]<<8) | Old[i+2]) ) continue;
+    Old[i]=Bits[i]; Old[i+1]=Bits[i+1]; Old[i+2]=Bits[i+2];
+    char *p=Payload+i/3*4;
+    char c0=AISArmorChars[(v>>18) & 0x3f];
+    char c1=AISArmorChars[(v>>12) & 0x3f];
+    char c2=AISArmorChars[(v>>6) & 0x3f];
+    char c3=AISArmorChars[v & 0x3f];
+    CheckSum^=p[0]^p[1]^p[2]^p[3]^c0^c1^c2^c3;
+    p[0]=c0; p[1]=c1; p[2]=c2; p[3]=c3;
+  }
+  if ( CheckSum!=0 ) {
+    CheckSum^=Sentence->CheckSum;
+    Sentence->CheckSum=CheckSum;
+    Sentence->Text[Sentence->Len-4]=HexChars[CheckSum>>4];
+    Sentence->Text[Sentence->Len-3]=HexChars[CheckSum & 0x0f];
+  }
+
+  memcpy(Buf, Sentence->Text, sizeof(Sentence->Text));
+  return Sentence->Len;
+}
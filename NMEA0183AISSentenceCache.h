@@ -0,0 +1,208 @@
+/*
+NMEA0183AISSentenceCache.h
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+// Already encoded static data sentences per MMSI: Message 5 of Class A targets,
+// Message 24 Part A and B of Class B targets. Static data is repeated by the targets
+// only every 6 minutes, so e.g. newly connected clients can get it from here at once.
+// Each part is stored with a key of the input fields of the encoder, so unchanged static
+// data is output again without encoding, armoring and formatting, see tAISEncoderContext.
+
+#ifndef _tNMEA0183AISSentenceCache_H_
+#define _tNMEA0183AISSentenceCache_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "NMEA0183AISMsg.h"
+#include "NMEA0183AISRegistry.h"
+
+#ifndef AIS_SENTENCE_CACHE_SIZE
+#define AIS_SENTENCE_CACHE_SIZE AIS_TABLE_SIZE(4,16,128)  // targets with cached sentences, least recently updated one is replaced. 316 bytes per target
+#endif
+
+// Message 5 has 2 sentences of up to 82 characters, Message 24 Part A and B 49 characters each
+#define AIS_STATIC_SENTENCES_LEN 168
+// Input fields of Message 5 (105 bytes) or Message 24 Part A (21 bytes) and Part B (48 bytes)
+#define AIS_STATIC_KEY_LEN 105
+#define AIS_STATIC_KEY_PART_B 32  // position of Part B key
+
+//*****************************************************************************
+// Input fields of the encoder of Message 5 or of one part of Message 24 in fixed order.
+// Texts are added with the characters the message takes, so equal keys give equal payloads.
+// Doubles are compared by their bits.
+class tAISStaticKey {
+  protected:
+    uint8_t Data[AIS_STATIC_KEY_LEN];
+    uint8_t Len;              // 0xff after overflow, such a key is never stored or found
+
+  public:
+    tAISStaticKey() : Len(0) {}
+
+    tAISStaticKey &Add(const void *Value, uint8_t Size) {
+      if ( Len<=sizeof(Data) && Len+Size<=sizeof(Data) ) { memcpy(Data+Len, Value, Size); Len+=Size; } else Len=0xff;
+      return *this;
+    }
+    tAISStaticKey &Add(uint8_t Value) { return Add(&Value, sizeof(Value)); }
+    tAISStaticKey &Add(uint16_t Value) { return Add(&Value, sizeof(Value)); }
+    tAISStaticKey &Add(uint32_t Value) { return Add(&Value, sizeof(Value)); }
+    tAISStaticKey &Add(double Value) { return Add(&Value, sizeof(Value)); }
+    // Chars characters of Text, 0 padded after its end
+    tAISStaticKey &AddText(const char *Text, uint8_t Chars);
+
+    const uint8_t *GetData() const { return Data; }
+    uint8_t GetLength() const { return Len; }
+    // FNV-1a on 32 bit words
+    uint32_t GetHash() const;
+};
+
+//*****************************************************************************
+// Complete "!AIVDM,...*hh\r\n" lines, Message 5 or Message 24 Part A followed by Part B
+class tAISStaticSentences {
+  protected:
+    uint8_t MessageType;      // 5 or 24, 0 = empty
+    uint8_t LenA;             // Message 5 or Message 24 Part A
+    uint8_t LenB;             // Message 24 Part B
+    uint8_t KeyLenA;          // key of part stored in Keys, 0 = none
+    uint8_t KeyLenB;
+    uint32_t HashA;
+    uint32_t HashB;
+    uint8_t Keys[AIS_STATIC_KEY_LEN];  // Message 5 or Part A, Part B at AIS_STATIC_KEY_PART_B
+    char Text[AIS_STATIC_SENTENCES_LEN+1];
+
+    friend class tAISStaticSentenceCache;
+    bool SameKey(bool PartB, const tAISStaticKey *Key) const;
+    bool SetPart(bool PartB, const char *Sentences, size_t Len, const tAISStaticKey *Key);
+
+  public:
+    tAISStaticSentences() : MessageType(0), LenA(0), LenB(0), KeyLenA(0), KeyLenB(0), HashA(0), HashB(0) { Text[0]=0; }
+
+    uint8_t GetMessageType() const { return MessageType; }
+    // All sentences, 0 terminated
+    const char *GetText() const { return Text; }
+    size_t GetLength() const { return LenA+LenB; }
+};
+
+//*****************************************************************************
+class tAISStaticSentenceCache {
+  public:
+    typedef tAISMMSIMap<tAISStaticSentences, AIS_SENTENCE_CACHE_SIZE> tMap;
+    static const uint16_t None=tMap::None;
+
+  protected:
+    tMap Map;
+
+  public:
+    void Clear() { Map.Clear(); }
+
+    // Store sentences of payload Bits with Length bits. Message 5 and Message 24 Part A, Part B
+    // or both chained (336 bits, as built by SetAISClassBMessage24) are accepted.
+    // Multi sentence messages get SequentialID, use the one of the copy sent.
+    bool Set(const uint8_t *Bits, uint16_t Length, char Channel, uint8_t SequentialID);
+    // Store sentences of message built by SetAISClassAMessage5 or SetAISClassBMessage24... after it has
+    // been sent with BuildFragment() or GetSentences(), so the cached copy has the same sequential ID.
+    bool Set(const tNMEA0183AISMsg &NMEA0183AISMsg, char Channel='A');
+    // Store already written sentences of Message 5 (PartB=false) or of one part of Message 24
+    // with the Key of their input fields. Without Key they are only kept for GetText(); this is
+    // also the case for the Set() functions above.
+    bool SetSentences(uint32_t UserID, uint8_t MessageType, bool PartB, const char *Sentences, size_t Len, const tAISStaticKey *Key=0);
+    // Copy all sentences of UserID to Buf, if they were stored with the same MessageType and keys.
+    // Use KeyB=0 for Message 5. Multi sentence messages get a new sequential ID from SequentialIDs.
+    // Returns length copied or 0.
+    size_t Get(uint32_t UserID, uint8_t MessageType, const tAISStaticKey &KeyA, const tAISStaticKey *KeyB, char *Buf, size_t BufSize,
+               tAISSequentialIDs &SequentialIDs) const;
+    // Copy sentences of Part A (Message 5) or Part B of UserID to Buf, if stored with the same MessageType and Key.
+    // Returns length copied or 0.
+    size_t GetPart(uint32_t UserID, uint8_t MessageType, bool PartB, const tAISStaticKey &Key, char *Buf, size_t BufSize,
+                   tAISSequentialIDs &SequentialIDs) const;
+
+    const tAISStaticSentences *Find(uint32_t UserID) const { return Map.Find(UserID); }
+    bool Remove(uint32_t UserID) { return Map.Remove(UserID); }
+    uint16_t Size() const { return Map.Size(); }
+
+    // Iterate by slot: for (uint16_t s=0; s<tAISStaticSentenceCache::Capacity; s++) if ( Cache.IsUsed(s) ) ...
+    // Slots do not move on updates, so the iteration can be spread over several calls.
+    static const uint16_t Capacity=AIS_SENTENCE_CACHE_SIZE;
+    bool IsUsed(uint16_t Slot) const { return Map.IsUsed(Slot); }
+    uint32_t GetUserID(uint16_t Slot) const { return Map.GetUserID(Slot); }
+    const tAISStaticSentences &GetAt(uint16_t Slot) const { return Map.GetValue(Slot); }
+};
+
+#ifndef AIS_POSITION_CACHE_SIZE
+#define AIS_POSITION_CACHE_SIZE AIS_TABLE_SIZE(4,32,128)  // targets with last position report sentence, least recently updated one is replaced. 99 bytes per target
+#endif
+
+// Position reports Message 1, 2, 3 and 18 have 168 bits in one sentence
+#define AIS_POSITION_PAYLOAD_LEN 168
+// "!AIVDM,1,1,,A,<28 characters>,0*hh\r\n"
+#define AIS_POSITION_SENTENCE_LEN 49
+
+//*****************************************************************************
+// Last position report sentence of a target together with its packed payload
+class tAISPositionSentence {
+  protected:
+    uint8_t Bits[AIS_BITS_TO_BYTES(AIS_POSITION_PAYLOAD_LEN)];
+    uint8_t Len;              // of Text, 0 = empty
+    uint8_t PayloadPos;       // first payload character in Text
+    uint8_t CheckSum;
+    char Channel;
+    char Text[AIS_POSITION_SENTENCE_LEN+1];
+
+    friend class tAISPositionSentenceCache;
+
+  public:
+    tAISPositionSentence() : Len(0), PayloadPos(0), CheckSum(0), Channel(0) { Text[0]=0; }
+
+    const uint8_t *GetPayloadBits() const { return Bits; }
+    const char *GetText() const { return Text; }
+    size_t GetLength() const { return Len; }
+};
+
+//*****************************************************************************
+// Incremental encoding of position reports. Consecutive reports of a target usually
+// differ only in position, SOG, COG, heading and seconds. The new payload is compared
+// with the previous one of the same MMSI, only the payload characters covering changed
+// bits are armored again and the checksum is patched with the changed characters.
+// See tAISEncoderContext::PositionCache.
+class tAISPositionSentenceCache {
+  public:
+    typedef tAISMMSIMap<tAISPositionSentence, AIS_POSITION_CACHE_SIZE> tMap;
+    static const uint16_t None=tMap::None;
+
+  protected:
+    tMap Map;
+
+  public:
+    void Clear() { Map.Clear(); }
+
+    // Write sentence of payload Bits with Length bits to Buf and keep it for the UserID in the payload.
+    // Payloads other than AIS_POSITION_PAYLOAD_LEN bits are written without caching.
+    // Returns length written or 0 if Buf is too small.
+    size_t Write(char *Buf, size_t BufSize, const uint8_t *Bits, uint16_t Length, char Channel);
+
+    const tAISPositionSentence *Find(uint32_t UserID) const { return Map.Find(UserID); }
+    bool Remove(uint32_t UserID) { return Map.Remove(UserID); }
+    uint16_t Size() const { return Map.Size(); }
+};
+
+#endif
@@ -0,0 +1,232 @@
+/*
+NMEA0183AISTargets.cpp
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "NMEA0183AISTargets.h"
+#include "NMEA0183AISDecoder.h"
+#include <string.h>
+
+//*****************************************************************************
+static void SetText(char *Dst, size_t DstSize, const char *Src) {
+  if ( Src==0 ) Src="";
+  strncpy(Dst, Src, DstSize-1);
+  Dst[DstSize-1]=0;
+}
+
+//*****************************************************************************
+// Find or add slot for UserID, new targets start without any data.
+uint16_t tAISTargetDB::Update(uint32_t UserID, uint32_t Now) {
+  bool Added;
+  uint16_t Slot=Index.Insert(UserID, &Added);
+  if ( Slot==None ) return None;
+  if ( Added ) {
+    Positions[Slot].MessageType=0;
+    Statics[Slot].Received=0;
+  }
+  Updated[Slot]=Now;
+  return Slot;
+}
+
+//*****************************************************************************
+bool tAISTargetDB::UpdateClassAPosition(uint32_t Now, uint8_t MessageType, uint8_t Repeat,
+                                        uint32_t UserID, double Latitude, double Longitude, bool Accuracy, bool RAIM, uint8_t Seconds,
+                                        double COG, double SOG, double Heading, double ROT, uint8_t NavStatus) {
+  uint16_t Slot=Update(UserID, Now);
+  if ( Slot==None ) return false;
+
+  tAISTargetPosition &Pos=Positions[Slot];
+  Pos.Latitude=Latitude;
+  Pos.Longitude=Longitude;
+  Pos.COG=COG;
+  Pos.SOG=SOG;
+  Pos.Heading=Heading;
+  Pos.ROT=ROT;
+  Pos.Time=Now;
+  Pos.MessageType=( MessageType>=1 && MessageType<=3 ? MessageType : 1 );
+  Pos.Repeat=Repeat;
+  Pos.NavStatus=NavStatus;
+  Pos.Seconds=Seconds;
+  Pos.Flags=( Accuracy ? tAISTargetPosition::Accuracy : 0 ) | ( RAIM ? tAISTargetPosition::RAIM : 0 );
+  return true;
+}
+
+//*****************************************************************************
+bool tAISTargetDB::UpdateClassBPosition(uint32_t Now, uint8_t Repeat, uint32_t UserID,
+                                        double Latitude, double Longitude, bool Accuracy, bool RAIM,
+                                        uint8_t Seconds, double COG, double SOG, double Heading, tN2kAISUnit Unit,
+                                        bool Display, bool DSC, bool Band, bool Msg22, bool Mode) {
+  uint16_t Slot=Update(UserID, Now);
+  if ( Slot==None ) return false;
+
+  tAISTargetPosition &Pos=Positions[Slot];
+  Pos.Latitude=Latitude;
+  Pos.Longitude=Longitude;
+  Pos.COG=COG;
+  Pos.SOG=SOG;
+  Pos.Heading=Heading;
+  Pos.ROT=N2kDoubleNA;
+  Pos.Time=Now;
+  Pos.MessageType=18;
+  Pos.Repeat=Repeat;
+  Pos.NavStatus=15;  // not defined
+  Pos.Seconds=Seconds;
+  Pos.Flags=( Accuracy ? tAISTargetPosition::Accuracy : 0 ) | ( RAIM ? tAISTargetPosition::RAIM : 0 ) |
+            ( Unit==N2kaisunit_ClassB_CS ? tAISTargetPosition::CSUnit : 0 ) |
+            ( Display ? tAISTargetPosition::Display : 0 ) | ( DSC ? tAISTargetPosition::DSC : 0 ) |
+            ( Band ? tAISTargetPosition::Band : 0 ) | ( Msg22 ? tAISTargetPosition::Msg22 : 0 ) |
+            ( Mode ? tAISTargetPosition::Mode : 0 );
+  return true;
+}
+
+//*****************************************************************************
+bool tAISTargetDB::UpdatePosition(uint32_t Now, const uint8_t *Bits, uint16_t Length) {
+  tAISDecodedMessage Msg;
+
+  if ( !AISDecodeMessage(Bits, Length, Msg) ) return false;
+  if ( Msg.MessageType>=1 && Msg.MessageType<=3 ) {
+    const tAISClassAPositionReport &A=Msg.ClassAPosition;
+    return UpdateClassAPosition(Now, A.MessageType, A.Repeat, A.UserID, A.Latitude, A.Longitude, A.Accuracy, A.RAIM, A.Seconds,
+                                A.COG, A.SOG, A.Heading, A.ROT, A.NavStatus);
+  }
+  if ( Msg.MessageType==18 ) {
+    const tAISClassBPositionReport &B=Msg.ClassBPosition;
+    return UpdateClassBPosition(Now, B.Repeat, B.UserID, B.Latitude, B.Longitude, B.Accuracy, B.RAIM, B.Seconds,
+                                B.COG, B.SOG, B.Heading, B.Unit, B.Display, B.DSC, B.Band, B.Msg22, B.Mode);
+  }
+  return false;
+}
+
+//*****************************************************************************
+bool tAISTargetDB::UpdateClassAStatic(uint32_t Now, uint8_t Repeat,
+                                      uint32_t UserID, uint32_t IMONumber, const char *Callsign, const char *Name,
+                                      uint8_t VesselType, double Length, double Beam, double PosRefStbd,
+                                      double PosRefBow, uint16_t ETAdate, double ETAtime, double Draught,
+                                      const char *Destination, tN2kGNSStype GNSStype, uint8_t DTE) {
+  uint16_t Slot=Update(UserID, Now);
+  if ( Slot==None ) return false;
+
+  tAISTargetStatic &Static=Statics[Slot];
+  Static.Time=Now;
+  Static.Received=tAISTargetStatic::Message5;  // Class B data is outdated now
+  Static.Repeat=Repeat;
+  Static.VesselType=VesselType;
+  Static.DTE=DTE;
+  Static.IMONumber=IMONumber;
+  Static.MothershipID=0;
+  SetText(Static.Callsign, sizeof(Static.Callsign), Callsign);
+  SetText(Static.Name, sizeof(Static.Name), Name);
+  Static.VendorID[0]=0;
+  SetText(Static.Destination, sizeof(Static.Destination), Destination);
+  Static.Length=Length;
+  Static.Beam=Beam;
+  Static.PosRefStbd=PosRefStbd;
+  Static.PosRefBow=PosRefBow;
+  Static.ETAtime=ETAtime;
+  Static.Draught=Draught;
+  Static.ETAdate=ETAdate;
+  Static.GNSStype=GNSStype;
+  return true;
+}
+
+//*****************************************************************************
+// Clear Class A only fields, when a target starts sending Class B static data
+static void StartClassBStatic(tAISTargetStatic &Static) {
+  if ( (Static.Received & (tAISTargetStatic::Message24A | tAISTargetStatic::Message24B))!=0 ) return;
+  Static.Received=0;
+  Static.Name[0]=0;
+  Static.Callsign[0]=0;
+  Static.VendorID[0]=0;
+  Static.Destination[0]=0;
+  Static.VesselType=0;
+  Static.DTE=1;  // not available
+  Static.IMONumber=0;
+  Static.MothershipID=0;
+  Static.Length=N2kDoubleNA;
+  Static.Beam=N2kDoubleNA;
+  Static.PosRefStbd=N2kDoubleNA;
+  Static.PosRefBow=N2kDoubleNA;
+  Static.ETAtime=N2kDoubleNA;
+  Static.Draught=N2kDoubleNA;
+  Static.ETAdate=N2kUInt16NA;
+  Static.GNSStype=N2kGNSSt_GPS;
+}
+
+//*****************************************************************************
+bool tAISTargetDB::UpdateClassBStaticPartA(uint32_t Now, uint8_t Repeat, uint32_t UserID, const char *Name) {
+  uint16_t Slot=Update(UserID, Now);
+  if ( Slot==None ) return false;
+
+  tAISTargetStatic &Static=Statics[Slot];
+  StartClassBStatic(Static);
+  Static.Time=Now;
+  Static.Received|=tAISTargetStatic::Message24A;
+  Static.Repeat=Repeat;
+  SetText(Static.Name, sizeof(Static.Name), Name);
+  return true;
+}
+
+//*****************************************************************************
+bool tAISTargetDB::UpdateClassBStaticPartB(uint32_t Now, uint8_t Repeat,
+                                           uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
+                                           double Length, double Beam, double PosRefStbd, double PosRefBow, uint32_t MothershipID) {
+  uint16_t Slot=Update(UserID, Now);
+  if ( Slot==None ) return false;
+
+  tAISTargetStatic &Static=Statics[Slot];
+  StartClassBStatic(Static);
+  Static.Time=Now;
+  Static.Received|=tAISTargetStatic::Message24B;
+  Static.Repeat=Repeat;
+  Static.VesselType=VesselType;
+  SetText(Static.VendorID, sizeof(Static.VendorID), VendorID);
+  SetText(Static.Callsign, sizeof(Static.Callsign), Callsign);
+  Static.Length=Length;
+  Static.Beam=Beam;
+  Static.PosRefStbd=PosRefStbd;
+  Static.PosRefBow=PosRefBow;
+  Static.MothershipID=MothershipID;
+  return true;
+}
+
+//*****************************************************************************
+const tAISTargetPosition *tAISTargetDB::GetPosition(uint32_t UserID) const {
+  uint16_t Slot=Index.Find(UserID);
+  if ( Slot==None || Positions[Slot].MessageType==0 ) return 0;
+  return &Positions[Slot];
+}
+
+//*****************************************************************************
+const tAISTargetStatic *tAISTargetDB::GetStatic(uint32_t UserID) const {
+  uint16_t Slot=Index.Find(UserID);
+  if ( Slot==None || Statics[Slot].Received==0 ) return 0;
+  return &Statics[Slot];
+}
+
+//*****************************************************************************
+// Age list is ordered by last update, so only the expired ones are visited.
+void tAISTargetDB::Expire(uint32_t Now, uint32_t MaxAge) {
+  uint16_t Slot;
+  while ( (Slot=Index.GetOldest())!=None && Now-Updated[Slot]>MaxAge ) {
+    Index.Remove(Index.GetUserID(Slot));
+  }
+}
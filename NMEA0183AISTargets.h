@@ -0,0 +1,163 @@
+/*
+NMEA0183AISTargets.h
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+// AIS target database: latest position report and static / voyage data per MMSI.
+// Positions are updated often and scanned e.g. for CPA, so they are kept in their
+// own array of small records. Static data is stored in a separate array and only
+// touched on Message 5 and 24.
+// Values use the same units as the SetAIS... parameters.
+
+#ifndef _tNMEA0183AISTargets_H_
+#define _tNMEA0183AISTargets_H_
+
+#include <stdint.h>
+#include <N2kTypes.h>
+#include "NMEA0183AISRegistry.h"
+
+#ifndef AIS_TARGET_DB_SIZE
+#define AIS_TARGET_DB_SIZE AIS_TABLE_SIZE(4,32,256)  // targets remembered, least recently updated one is replaced. 228 bytes per target
+#endif
+
+//*****************************************************************************
+// Latest position report, Message Type 1, 2, 3 or 18
+struct tAISTargetPosition {
+  enum tFlags {
+    Accuracy=0x01,
+    RAIM=0x02,
+    CSUnit=0x04,              // Class B only, see tN2kAISUnit
+    Display=0x08,
+    DSC=0x10,
+    Band=0x20,
+    Msg22=0x40,
+    Mode=0x80
+  };
+
+  double Latitude;          // [deg]
+  double Longitude;         // [deg]
+  double COG;               // [rad]
+  double SOG;               // [m/s]
+  double Heading;           // [rad]
+  double ROT;               // [rad/s], Class A only
+  uint32_t Time;            // of last update [ms]
+  uint8_t MessageType;      // 0 = no position received yet
+  uint8_t Repeat;
+  uint8_t NavStatus;        // Class A only
+  uint8_t Seconds;
+  uint8_t Flags;            // tFlags
+
+  bool IsSet(tFlags Flag) const { return (Flags & Flag)!=0; }
+};
+
+//*****************************************************************************
+// Latest static data, Message Type 5 (Class A) or 24 Part A and B (Class B)
+struct tAISTargetStatic {
+  enum tReceived {
+    Message5=0x01,
+    Message24A=0x02,
+    Message24B=0x04
+  };
+
+  uint32_t Time;            // of last update [ms]
+  uint8_t Received;         // tReceived, 0 = no static data received yet
+  uint8_t Repeat;
+  uint8_t VesselType;
+  uint8_t DTE;              // Class A only
+  uint32_t IMONumber;       // Class A only
+  uint32_t MothershipID;    // Class B only
+  char Callsign[8];
+  char Name[21];
+  char VendorID[8];         // Class B only
+  char Destination[21];     // Class A only
+  double Length;            // [m]
+  double Beam;              // [m]
+  double PosRefStbd;        // [m]
+  double PosRefBow;         // [m]
+  double ETAtime;           // [s] since midnight, Class A only
+  double Draught;           // [m], Class A only
+  uint16_t ETAdate;         // [days] since 1970, Class A only
+  tN2kGNSStype GNSStype;    // Class A only
+};
+
+//*****************************************************************************
+class tAISTargetDB {
+  public:
+    typedef tAISMMSIIndex<AIS_TARGET_DB_SIZE> tIndex;
+    static const uint16_t None=tIndex::None;
+
+  protected:
+    tIndex Index;
+    uint32_t Updated[AIS_TARGET_DB_SIZE];    // last update of any kind [ms]
+    tAISTargetPosition Positions[AIS_TARGET_DB_SIZE];
+    tAISTargetStatic Statics[AIS_TARGET_DB_SIZE];
+
+    uint16_t Update(uint32_t UserID, uint32_t Now);
+
+  public:
+    tAISTargetDB() { Clear(); }
+    void Clear() { Index.Clear(); }
+
+    // Update target UserID with data received at Now [ms], e.g. millis().
+    // Unknown targets are added, replacing the least recently updated one, if the table is full.
+    // Return false for UserID 0.
+    bool UpdateClassAPosition(uint32_t Now, uint8_t MessageType, uint8_t Repeat,
+                              uint32_t UserID, double Latitude, double Longitude, bool Accuracy, bool RAIM, uint8_t Seconds,
+                              double COG, double SOG, double Heading, double ROT, uint8_t NavStatus);
+    bool UpdateClassAStatic(uint32_t Now, uint8_t Repeat,
+                            uint32_t UserID, uint32_t IMONumber, const char *Callsign, const char *Name,
+                            uint8_t VesselType, double Length, double Beam, double PosRefStbd,
+                            double PosRefBow, uint16_t ETAdate, double ETAtime, double Draught,
+                            const char *Destination, tN2kGNSStype GNSStype, uint8_t DTE);
+    bool UpdateClassBPosition(uint32_t Now, uint8_t Repeat, uint32_t UserID,
+                              double Latitude, double Longitude, bool Accuracy, bool RAIM,
+                              uint8_t Seconds, double COG, double SOG, double Heading, tN2kAISUnit Unit,
+                              bool Display, bool DSC, bool Band, bool Msg22, bool Mode);
+    // Position report Message 1, 2, 3 or 18 from packed payload Bits with Length bits, e.g.
+    // tNMEA0183AISMsg::GetPayloadBits(). Returns false also for other messages.
+    bool UpdatePosition(uint32_t Now, const uint8_t *Bits, uint16_t Length);
+    bool UpdateClassBStaticPartA(uint32_t Now, uint8_t Repeat, uint32_t UserID, const char *Name);
+    bool UpdateClassBStaticPartB(uint32_t Now, uint8_t Repeat,
+                                 uint32_t UserID, uint8_t VesselType, const char *VendorID, const char *Callsign,
+                                 double Length, double Beam, double PosRefStbd, double PosRefBow, uint32_t MothershipID);
+
+    // Latest data of UserID or nullptr, if nothing of that kind has been received
+    const tAISTargetPosition *GetPosition(uint32_t UserID) const;
+    const tAISTargetStatic *GetStatic(uint32_t UserID) const;
+
+    bool Remove(uint32_t UserID) { return Index.Remove(UserID); }
+    // Remove targets not updated within MaxAge [ms]
+    void Expire(uint32_t Now, uint32_t MaxAge);
+    uint16_t Size() const { return Index.Size(); }
+
+    // Iterate targets from least to most recently updated:
+    // for (uint16_t s=DB.GetOldest(); s!=tAISTargetDB::None; s=DB.GetNewer(s)) { ... }
+    uint16_t GetOldest() const { return Index.GetOldest(); }
+    uint16_t GetNewer(uint16_t Slot) const { return Index.GetNewer(Slot); }
+    uint32_t GetUserID(uint16_t Slot) const { return Index.GetUserID(Slot); }
+    uint32_t GetUpdated(uint16_t Slot) const { return Updated[Slot]; }
+    // Check MessageType!=0 and Received!=0 for valid data
+    const tAISTargetPosition &GetPositionAt(uint16_t Slot) const { return Positions[Slot]; }
+    const tAISTargetStatic &GetStaticAt(uint16_t Slot) const { return Statics[Slot]; }
+};
+
+#endif
@@ -0,0 +1,181 @@
+/*
+AISFixedPointTest.cpp
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+// Equivalence of AIS_FIXED_POINT_CONVERSIONS 0 and 1. All encoders taking double values are fed with
+// special values (NaN, +-infinity, +-0, N/A, subnormal, huge), values around the range limits and
+// rounding points of each field and random values. The program prints a hash of the sentences per
+// field; both builds must print the same. With -v each sentence is printed instead, for diff.
+// EncodeAISClassABMessage1Batch() is also checked against EncodeAISClassABMessage1To() for the same
+// values; the program returns 1 on a difference.
+//
+// Build on a PC in the library directory, with NMEA2000 and NMEA0183 libraries next to it:
+//   for f in 0 1; do g++ -std=c++11 -O2 -DAIS_FIXED_POINT_CONVERSIONS=$f -I. -I../NMEA2000/src -I../NMEA0183/src
+//     -o AISFixedPointTest$f extras/test/AISFixedPointTest.cpp NMEA0183AIS*.cpp ../NMEA2000/src/N2kMsg.cpp
+//     ../NMEA2000/src/N2kStream.cpp ../NMEA0183/src/NMEA0183Msg.cpp && ./AISFixedPointTest$f > AISFixedPointTest$f.txt; done
+//   cmp AISFixedPointTest0.txt AISFixedPointTest1.txt
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <vector>
+#include "NMEA0183AISMessages.h"
+
+static bool Verbose=false;
+static unsigned long Failed=0;
+
+//*****************************************************************************
+// Deterministic random numbers, same in both builds
+static uint64_t RandomState=0x9e3779b97f4a7c15ULL;
+static double Random(double Min, double Max) {
+  RandomState^=RandomState<<13; RandomState^=RandomState>>7; RandomState^=RandomState<<17;
+  return Min+(Max-Min)*(double)(RandomState>>11)/9007199254740992.0;
+}
+
+//*****************************************************************************
+// Special values, +-Limits and rounding points Scale*(k+Offset)/Steps for k=-Steps...Steps with 4 ulps around
+// them and random values in +-1.5 * Range
+static std::vector<double> Values(double Range, double Scale, int Steps, double Offset, const double *Limits, size_t nLimits) {
+  const double Specials[]={ NAN, -NAN, INFINITY, -INFINITY, 0.0, -0.0, N2kDoubleNA, 1e12, -1e12, DBL_MAX, -DBL_MAX,
+                            DBL_MIN, -DBL_MIN, 4.9e-324, -4.9e-324, 1e-300, 3e9, -3e9 };
+  std::vector<double> v(Specials, Specials+sizeof(Specials)/sizeof(Specials[0]));
+
+  for (size_t i=0; i<nLimits; i++) {
+    for (double x : { Limits[i], -Limits[i] }) {
+      double l=x, u=x;
+      v.push_back(x);
+      for (int n=0; n<4; n++) { l=nextafter(l, -INFINITY); u=nextafter(u, INFINITY); v.push_back(l); v.push_back(u); }
+    }
+  }
+  for (int k=-Steps; k<=Steps; k++) {
+    double x=Scale*(k+Offset)/Steps, l=x, u=x;
+    v.push_back(x);
+    for (int n=0; n<4; n++) { l=nextafter(l, -INFINITY); u=nextafter(u, INFINITY); v.push_back(l); v.push_back(u); }
+  }
+  for (int n=0; n<100000; n++) v.push_back(Random(-1.5*Range, 1.5*Range));
+  return v;
+}
+
+//*****************************************************************************
+struct tHash {
+  const char *Name;
+  uint64_t Hash;
+  unsigned long Count;
+
+  tHash(const char *_Name) : Name(_Name), Hash(0xcbf29ce484222325ULL), Count(0) {}
+  void Add(double Value, const char *Sentences) {
+    if ( Verbose ) printf("%s %a %s", Name, Value, Sentences);
+    for (const char *p=Sentences; *p!=0; p++) { Hash^=(uint8_t)*p; Hash*=0x100000001b3ULL; }
+    Count++;
+  }
+  void Print() const { if ( !Verbose ) printf("%s %lu %016llx\n", Name, Count, (unsigned long long)Hash); }
+};
+
+//*****************************************************************************
+enum tPositionField { pfLatitude, pfLongitude, pfSOG, pfCOG, pfHeading, pfROT };
+
+// Message 1 with one field set to each of Values, others valid. Batch result must be the same.
+static void CheckPosition(const char *Name, tPositionField Field, const std::vector<double> &Values) {
+  tHash Hash(Name);
+  size_t n=Values.size();
+  std::vector<uint32_t> UserID(n, 211234567);
+  std::vector<double> Latitude(n, 54.1), Longitude(n, 10.5), SOG(n, 5.0), COG(n, 1.0), Heading(n, 2.0), ROT(n, 0.01);
+  std::vector<double> *Fields[]={ &Latitude, &Longitude, &SOG, &COG, &Heading, &ROT };
+  *Fields[Field]=Values;
+
+  std::vector<char> Scalar(n*AISMessage1BufSize+1);
+  size_t Len=0;
+  for (size_t i=0; i<n; i++) {
+    char *Buf=&Scalar[Len];
+    Len+=EncodeAISClassABMessage1To(Buf, AISMessage1BufSize, 1, 0, UserID[i], Latitude[i], Longitude[i], false, false, 60,
+                                    COG[i], SOG[i], Heading[i], ROT[i], 15);
+    Hash.Add(Values[i], Buf);
+  }
+  Hash.Print();
+
+  tAISPositionBatch Batch={ n, UserID.data(), Latitude.data(), Longitude.data(), SOG.data(), COG.data(), Heading.data(),
+                            ROT.data(), 0, 0, 0, 0, 0, 0 };
+  std::vector<char> Batched(Scalar.size());
+  size_t Encoded;
+  size_t BatchLen=EncodeAISClassABMessage1Batch(Batched.data(), Batched.size(), Batch, Encoded);
+  if ( Encoded!=n || BatchLen!=Len || memcmp(Scalar.data(), Batched.data(), Len)!=0 ) {
+    fprintf(stderr, "%s: batch differs from scalar encoding\n", Name);
+    Failed++;
+  }
+}
+
+//*****************************************************************************
+enum tStaticField { sfLength, sfBeam, sfPosRefStbd, sfPosRefBow, sfDraught };
+
+// Message 5 and Message 24 Part B with one field set to each of Values, others valid
+static void CheckStatic(const char *Name, tStaticField Field, const std::vector<double> &Values) {
+  tHash Hash(Name);
+  char Buf[AISMessage5BufSize];
+
+  for (double v : Values) {
+    double Fields[]={ 12.0, 4.0, 2.0, 8.0, 1.8 };
+    Fields[Field]=v;
+    size_t Len=EncodeAISClassAMessage5To(Buf, sizeof(Buf), 5, 0, 211234567, 9123456, "DA1234", "TEST", 36,
+                                         Fields[sfLength], Fields[sfBeam], Fields[sfPosRefStbd], Fields[sfPosRefBow],
+                                         18000, 43200.0, Fields[sfDraught], "KIEL", N2kGNSSt_GPS, 1);
+    Len+=EncodeAISClassBMessage24PartBTo(Buf+Len, sizeof(Buf)-Len, 24, 0, 211234567, 36, "VENDOR", "DA1234",
+                                         Fields[sfLength], Fields[sfBeam], Fields[sfPosRefStbd], Fields[sfPosRefBow], 0);
+    Hash.Add(v, Buf);
+  }
+  Hash.Print();
+}
+
+//*****************************************************************************
+int main(int argc, char *argv[]) {
+  const double pi=3.1415926535897932384626433832795;
+  const double knToms=1852.0/3600.0;
+  Verbose=( argc>1 && strcmp(argv[1], "-v")==0 );
+
+  const double LatLimits[]={ 90.0, 91.0 };
+  const double LonLimits[]={ 180.0, 181.0 };
+  const double SOGLimits[]={ 102.2*knToms, 102.25*knToms, 102.3*knToms };
+  const double COGLimits[]={ 2*pi, 359.95/180.0*pi };
+  const double HeadingLimits[]={ 359.0/180.0*pi, 359.5/180.0*pi, 2*pi };
+  const double ROTLimits[]={ 127.5/(60*180.0)*pi, 128.0/(60*180.0)*pi };
+  const double LengthLimits[]={ 511.0, 519.0, 1023.0, 1024.0, 2147483648.0 };
+  const double BeamLimits[]={ 63.0, 65.0, 1023.0, 1024.0 };
+  const double DraughtLimits[]={ 25.5 };
+
+  // Truncation / ceil points: latitude and longitude 1/600000 deg, dimensions 1 m, draught 0.1 m.
+  // Rounding points: SOG 0.1 kn, COG 0.1 deg, heading 1 deg, ROT 1 deg/min.
+  CheckPosition("Latitude", pfLatitude, Values(90.0, 0.01, 6000, 0.0, LatLimits, 2));
+  CheckPosition("Longitude", pfLongitude, Values(180.0, 0.01, 6000, 0.0, LonLimits, 2));
+  CheckPosition("SOG", pfSOG, Values(102.2*knToms, 102.4*knToms, 1024, 0.5, SOGLimits, 3));
+  CheckPosition("COG", pfCOG, Values(2*pi, 2*pi, 3600, 0.5, COGLimits, 2));
+  CheckPosition("Heading", pfHeading, Values(2*pi, 2*pi, 360, 0.5, HeadingLimits, 3));
+  CheckPosition("ROT", pfROT, Values(128.0/(60*180.0)*pi, 128.0/(60*180.0)*pi, 128, 0.5, ROTLimits, 2));
+  CheckStatic("Length", sfLength, Values(1023.0, 1024.0, 1024, 0.0, LengthLimits, 5));
+  CheckStatic("Beam", sfBeam, Values(1023.0, 64.0, 64, 0.0, BeamLimits, 4));
+  CheckStatic("PosRefStbd", sfPosRefStbd, Values(63.0, 64.0, 64, 0.0, BeamLimits, 4));
+  CheckStatic("PosRefBow", sfPosRefBow, Values(511.0, 512.0, 512, 0.0, LengthLimits, 5));
+  CheckStatic("Draught", sfDraught, Values(25.5, 25.6, 256, 0.0, DraughtLimits, 1));
+
+  if ( Failed>0 ) printf("%lu failed\n", Failed);
+  return ( Failed==0 ? 0 : 1 );
+}
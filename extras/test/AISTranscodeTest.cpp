@@ -0,0 +1,177 @@
+/*
+AISTranscodeTest.cpp
+
+Copyright (c) 2026 Ronnie Zeiller, www.zeiller.eu
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+// Equivalence of the direct transcoding of PGN 129038 and 129039 (SetAISClassABMessage1(..., N2kMsg),
+// EncodeAIS...To(..., N2kMsg)) with ParseN2kPGN129038/129039 of the NMEA2000 library followed by
+// the functions with double parameters. All 2^16 raw values of COG, SOG, Heading and ROT, all
+// values of the bit field bytes and sampled raw latitude and longitude, including the limits
+// and "not available", are checked. AISTranscodeN2kPosition() followed by tAISPositionSentenceCache::Write()
+// on the returned channel, as in the WiFi example, is checked the same way; the cache is shared by all
+// reports, so patching of the previous sentence is covered. Returns 0, if all sentences are identical.
+//
+// Build on a PC in the library directory, with NMEA2000 and NMEA0183 libraries next to it:
+//   g++ -std=c++11 -O2 -I. -I../NMEA2000/src -I../NMEA0183/src -o AISTranscodeTest extras/test/AISTranscodeTest.cpp
+//       NMEA0183AIS*.cpp ../NMEA2000/src/N2kMsg.cpp ../NMEA2000/src/N2kMessages.cpp ../NMEA2000/src/N2kStream.cpp
+//       ../NMEA0183/src/NMEA0183Msg.cpp
+
+#include <stdio.h>
+#include <string.h>
+#include <N2kMsg.h>
+#include <N2kMessages.h>
+#include "NMEA0183AISMessages.h"
+
+struct tRaw {
+  uint8_t MessageID;        // with Repeat in bits 6, 7
+  uint32_t UserID;
+  uint32_t Longitude;       // [1e-7 deg]
+  uint32_t Latitude;        // [1e-7 deg]
+  uint8_t AccRAIMSeconds;
+  uint16_t COG;             // [1e-4 rad]
+  uint16_t SOG;             // [0.01 m/s]
+  uint16_t Heading;         // [1e-4 rad]
+  uint16_t ROT;             // [3.125e-5 rad/s], signed, 129038 only
+  uint8_t NavStatus;        // 129038 only
+  uint8_t Flags;            // Unit, Display, DSC, Band, Msg22, Mode in bits 2...7, 129039 only
+};
+
+static unsigned long Checked=0;
+static unsigned long Failed=0;
+static tAISPositionSentenceCache PositionSentences;
+
+//*****************************************************************************
+static void SetN2kMsg(tN2kMsg &N2kMsg, bool ClassB, const tRaw &Raw) {
+  N2kMsg.SetPGN(ClassB ? 129039UL : 129038UL);
+  N2kMsg.AddByte(Raw.MessageID);
+  N2kMsg.Add4ByteUInt(Raw.UserID);
+  N2kMsg.Add4ByteUInt(Raw.Longitude);
+  N2kMsg.Add4ByteUInt(Raw.Latitude);
+  N2kMsg.AddByte(Raw.AccRAIMSeconds);
+  N2kMsg.Add2ByteUInt(Raw.COG);
+  N2kMsg.Add2ByteUInt(Raw.SOG);
+  N2kMsg.AddByte(0xff);  // communication state
+  N2kMsg.AddByte(0xff);
+  N2kMsg.AddByte(0xff);  // transceiver information
+  N2kMsg.Add2ByteUInt(Raw.Heading);
+  if ( ClassB ) {
+    N2kMsg.AddByte(0xff);  // regional application
+    N2kMsg.AddByte(Raw.Flags);
+    N2kMsg.AddByte(0xff);
+  } else {
+    N2kMsg.Add2ByteUInt(Raw.ROT);
+    N2kMsg.AddByte(Raw.NavStatus);
+    N2kMsg.AddByte(0xff);
+  }
+}
+
+//*****************************************************************************
+static void Check(bool ClassB, const tRaw &Raw) {
+  tN2kMsg N2kMsg;
+  char Parsed[AISMessage18BufSize], Direct[AISMessage18BufSize], Cached[AISMessage18BufSize];
+  size_t ParsedLen=0, DirectLen, CachedLen=0;
+  uint8_t Bits[AISPositionPayloadBytes];
+  uint16_t Length;
+  char Channel;
+  uint8_t MessageID, Seconds;
+  tN2kAISRepeat Repeat;
+  uint32_t UserID;
+  double Latitude, Longitude, COG, SOG, Heading, ROT;
+  bool Accuracy, RAIM;
+
+  SetN2kMsg(N2kMsg, ClassB, Raw);
+  if ( ClassB ) {
+    tN2kAISTransceiverInformation TransceiverInformation;
+    tN2kAISUnit Unit;
+    bool Display, DSC, Band, Msg22, State;
+    tN2kAISMode Mode;
+    if ( ParseN2kPGN129039(N2kMsg, MessageID, Repeat, UserID, Latitude, Longitude, Accuracy, RAIM, Seconds, COG, SOG,
+                           TransceiverInformation, Heading, Unit, Display, DSC, Band, Msg22, Mode, State) ) {
+      ParsedLen=EncodeAISClassBMessage18To(Parsed, sizeof(Parsed), MessageID, Repeat, UserID, Latitude, Longitude, Accuracy, RAIM,
+                                           Seconds, COG, SOG, Heading, Unit, Display, DSC, Band, Msg22, Mode, State);
+    }
+    DirectLen=EncodeAISClassBMessage18To(Direct, sizeof(Direct), N2kMsg);
+  } else {
+    tN2kAISNavStatus NavStatus;
+    if ( ParseN2kPGN129038(N2kMsg, MessageID, Repeat, UserID, Latitude, Longitude, Accuracy, RAIM, Seconds, COG, SOG,
+                           Heading, ROT, NavStatus) ) {
+      ParsedLen=EncodeAISClassABMessage1To(Parsed, sizeof(Parsed), MessageID, Repeat, UserID, Latitude, Longitude, Accuracy, RAIM,
+                                           Seconds, COG, SOG, Heading, ROT, NavStatus);
+    }
+    DirectLen=EncodeAISClassABMessage1To(Direct, sizeof(Direct), N2kMsg);
+  }
+  if ( AISTranscodeN2kPosition(Bits, Length, Channel, N2kMsg) ) {
+    CachedLen=PositionSentences.Write(Cached, sizeof(Cached), Bits, Length, Channel);
+  }
+
+  Checked++;
+  if ( ParsedLen==DirectLen && ParsedLen==CachedLen && ( ParsedLen==0 || ( strcmp(Parsed, Direct)==0 && strcmp(Parsed, Cached)==0 ) ) ) return;
+  if ( Failed++<10 ) {
+    printf("PGN %s COG %04x SOG %04x Heading %04x ROT %04x Lat %08x Lon %08x\n  parsed %s  direct %s  cached %s",
+           ClassB ? "129039" : "129038", Raw.COG, Raw.SOG, Raw.Heading, Raw.ROT, (unsigned)Raw.Latitude, (unsigned)Raw.Longitude,
+           ( ParsedLen>0 ? Parsed : "-\n" ), ( DirectLen>0 ? Direct : "-\n" ), ( CachedLen>0 ? Cached : "-\n" ));
+  }
+}
+
+//*****************************************************************************
+int main() {
+  const tRaw Base={ 1, 211234567, 105000000, 540000000, 0x11, 10000, 500, 20000, 0, 0, 0x10 };
+  // Raw latitude and longitude at the limits of the AIS range, around 0 and "not available"
+  const uint32_t Limits[]={ 0, 1, 0xffffffff, 900000000, 900000001, (uint32_t)-900000000, (uint32_t)-900000001,
+                            1800000000, 1800000001, (uint32_t)-1800000000, (uint32_t)-1800000001,
+                            0x7ffffffe, 0x7fffffff, 0x80000000, 166, 167, (uint32_t)-166, (uint32_t)-167 };
+
+  for (int ClassB=0; ClassB<2; ClassB++) {
+    tRaw Raw=Base;
+
+    for (uint32_t v=0; v<0x10000; v++) {
+      Raw.COG=v; Raw.SOG=v; Raw.Heading=v; Raw.ROT=v;
+      Check(ClassB, Raw);
+      // each field alone, others at Base, so "not available" of one field does not hide another
+      Raw=Base; Raw.COG=v; Check(ClassB, Raw);
+      Raw=Base; Raw.SOG=v; Check(ClassB, Raw);
+      Raw=Base; Raw.Heading=v; Check(ClassB, Raw);
+      Raw=Base; Raw.ROT=v; Check(ClassB, Raw);
+    }
+
+    for (uint32_t v=0; v<0x100; v++) {
+      Raw=Base; Raw.MessageID=v; Check(ClassB, Raw);
+      Raw=Base; Raw.AccRAIMSeconds=v; Check(ClassB, Raw);
+      Raw=Base; Raw.NavStatus=v; Check(ClassB, Raw);
+      Raw=Base; Raw.Flags=v; Check(ClassB, Raw);
+    }
+
+    for (size_t i=0; i<sizeof(Limits)/sizeof(Limits[0]); i++) {
+      for (size_t j=0; j<sizeof(Limits)/sizeof(Limits[0]); j++) {
+        Raw=Base; Raw.Latitude=Limits[i]; Raw.Longitude=Limits[j]; Check(ClassB, Raw);
+      }
+    }
+    // Whole 32 bit range with a prime step, so all last digits are hit
+    for (uint64_t v=0; v<0x100000000ULL; v+=9973) {
+      Raw=Base; Raw.Latitude=(uint32_t)v; Check(ClassB, Raw);
+      Raw=Base; Raw.Longitude=(uint32_t)v; Check(ClassB, Raw);
+    }
+  }
+
+  printf("%lu checked, %lu failed\n", Checked, Failed);
+  return ( Failed==0 ? 0 : 1 );
+}